@@ -0,0 +1,64 @@
+# Copyright 2020 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Builds the keymap of tests/$(TEST) together with the test matrix and timer
+# into a native program that replays a recorded key trace, see tests/replay
+
+ifndef VERBOSE
+.SILENT:
+endif
+
+.DEFAULT_GOAL := all
+
+include common.mk
+
+TARGET=replay/$(TEST)
+
+REPLAY_OBJ = $(BUILD_DIR)/replay_obj
+
+OUTPUTS := $(REPLAY_OBJ)/$(TEST)
+
+CREATE_MAP := no
+
+all: elf
+
+VPATH += $(COMMON_VPATH)
+PLATFORM:=TEST
+PLATFORM_KEY:=test
+
+include tests/$(TEST)/rules.mk
+# the replay reports the key to report latency
+LATENCY_TRACE_ENABLE = yes
+
+include common_features.mk
+include $(TMK_PATH)/common.mk
+
+$(REPLAY_OBJ)/$(TEST)_SRC := \
+	tests/$(TEST)/keymap.c \
+	$(TMK_COMMON_SRC) \
+	$(QUANTUM_SRC) \
+	$(SRC) \
+	tests/test_common/matrix.c \
+	tests/replay/replay.c
+$(REPLAY_OBJ)/$(TEST)_INC := $(VPATH) $(TOP_DIR)/tests/test_common
+$(REPLAY_OBJ)/$(TEST)_DEFS := $(TMK_COMMON_DEFS) $(OPT_DEFS) -DTIMER_SIMULATION
+$(REPLAY_OBJ)/$(TEST)_CONFIG := tests/$(TEST)/config.h
+
+include $(TMK_PATH)/native.mk
+include $(TMK_PATH)/rules.mk
+
+
+$(shell mkdir -p $(BUILD_DIR)/replay 2>/dev/null)
+$(shell mkdir -p $(REPLAY_OBJ) 2>/dev/null)
@@ -413,6 +413,21 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
     endif
 endif
 
+ifeq ($(strip $(SHIFT_REGISTER_MATRIX_ENABLE)), yes)
+    OPT_DEFS += -DSHIFT_REGISTER_MATRIX_ENABLE
+    COMMON_VPATH += $(QUANTUM_DIR)/shift_register
+    QUANTUM_LIB_SRC += spi_master.c
+    QUANTUM_SRC += $(QUANTUM_DIR)/shift_register/shift_register_matrix.c
+endif
+
+ifeq ($(strip $(ANALOG_MATRIX_ENABLE)), yes)
+    OPT_DEFS += -DANALOG_MATRIX_ENABLE
+    COMMON_VPATH += $(QUANTUM_DIR)/analog_matrix
+    SRC += analog.c
+    QUANTUM_SRC += $(QUANTUM_DIR)/analog_matrix/analog_matrix.c
+    POST_CONFIG_H += $(QUANTUM_DIR)/analog_matrix/analog_matrix_post_config.h
+endif
+
 # Support for translating old names to new names:
 ifeq ($(strip $(DEBOUNCE_TYPE)),sym_g)
     DEBOUNCE_TYPE:=sym_defer_g
@@ -436,7 +451,9 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
     OPT_DEFS += -DSPLIT_KEYBOARD
 
     # Include files used by all split keyboards
-    QUANTUM_SRC += $(QUANTUM_DIR)/split_common/split_util.c
+    QUANTUM_SRC += $(QUANTUM_DIR)/split_common/split_util.c \
+                   $(QUANTUM_DIR)/split_common/split_sync.c \
+                   $(QUANTUM_DIR)/split_common/split_stats.c
 
     # Determine which (if any) transport files are required
     ifneq ($(strip $(SPLIT_TRANSPORT)), custom)
@@ -454,6 +471,9 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
         else
             QUANTUM_LIB_SRC += serial_$(strip $(SERIAL_DRIVER)).c
         endif
+        ifeq ($(strip $(SERIAL_DRIVER)), usart_duplex)
+            QUANTUM_LIB_SRC += serial_duplex.c
+        endif
     endif
     COMMON_VPATH += $(QUANTUM_PATH)/split_common
 endif
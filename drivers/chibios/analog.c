@@ -94,6 +94,9 @@
 #    define ADC_BUFFER_DEPTH 1
 #endif
 
+// Length of the regular sequence, the most channels analogReadPins() converts at once
+#define ADC_MAX_SEQUENCE 16
+
 // For more sampling rate options, look at hal_adc_lld.h in ChibiOS
 #ifndef ADC_SAMPLING_RATE
 #    define ADC_SAMPLING_RATE ADC_SMPR_SMP_1P5
@@ -106,6 +109,7 @@
 
 static ADCConfig   adcCfg = {};
 static adcsample_t sampleBuffer[ADC_NUM_CHANNELS * ADC_BUFFER_DEPTH];
+static adcsample_t sequenceBuffer[ADC_MAX_SEQUENCE];
 
 // Initialize to max number of ADCs, set to empty object to initialize all to false.
 static bool adcInitialized[ADC_COUNT] = {};
@@ -274,3 +278,87 @@ int16_t adc_read(adc_mux mux) {
     return *sampleBuffer;
 #endif
 }
+
+bool analogReadPins(const pin_t pins[], uint8_t count, uint16_t values[]) {
+    ADCConversionGroup group    = adcConversionGroup;
+    uint8_t            adc      = 0xFF;
+    uint8_t            channels = 0;
+    uint8_t            index[count];
+#if defined(USE_ADCV1)
+    group.chselr = 0;
+#elif defined(USE_ADCV2)
+    group.sqr1 = group.sqr2 = group.sqr3 = 0;
+#else
+    group.sqr[0] = group.sqr[1] = group.sqr[2] = group.sqr[3] = 0;
+#endif
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (pins[i] == NO_PIN) {
+            index[i] = 0xFF;
+            continue;
+        }
+
+        adc_mux mux = pinToMux(pins[i]);
+        if (channels == ADC_MAX_SEQUENCE || (adc != 0xFF && mux.adc != adc)) {
+            // the pins can't be converted together
+            return false;
+        }
+        adc = mux.adc;
+        palSetLineMode(pins[i], PAL_MODE_INPUT_ANALOG);
+
+#if defined(USE_ADCV1)
+        // converted in the order of the channel numbers, not of the pins
+        if (group.chselr & (1 << mux.input)) {
+            return false;
+        }
+        group.chselr |= 1 << mux.input;
+#elif defined(USE_ADCV2)
+        uint32_t* sqr[] = {&group.sqr3, &group.sqr2, &group.sqr1};
+        *sqr[channels / 6] |= (uint32_t)mux.input << (5 * (channels % 6));
+#else
+        // SQR1 starts with the sequence length, then holds 4 channels, the others 5
+        uint8_t slot = channels + 1;
+        group.sqr[slot / 5] |= (uint32_t)mux.input << (6 * (slot % 5));
+#endif
+        index[i] = mux.input;
+        channels++;
+    }
+
+    ADCDriver* targetDriver = intToADCDriver(adc);
+    if (!targetDriver) {
+        return false;
+    }
+
+#if defined(USE_ADCV1)
+    // turn channel numbers into positions in the ascending scan
+    for (uint8_t i = 0; i < count; i++) {
+        if (index[i] != 0xFF) {
+            index[i] = __builtin_popcount(group.chselr & ((1 << index[i]) - 1));
+        }
+    }
+#else
+    for (uint8_t i = 0, position = 0; i < count; i++) {
+        if (index[i] != 0xFF) {
+            index[i] = position++;
+        }
+    }
+#endif
+#if defined(USE_ADCV2)
+    group.sqr1 |= ADC_SQR1_NUM_CH(channels);
+#endif
+    group.num_channels = channels;
+
+    manageAdcInitializationDriver(adc, targetDriver);
+    if (adcConvert(targetDriver, &group, &sequenceBuffer[0], 1) != MSG_OK) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+#ifdef USE_ADCV2
+        values[i] = index[i] == 0xFF ? 0 : sequenceBuffer[index[i]] >> (12 - ADC_RESOLUTION);
+#else
+        values[i] = index[i] == 0xFF ? 0 : sequenceBuffer[index[i]];
+#endif
+    }
+    return true;
+}
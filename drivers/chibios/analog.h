@@ -36,6 +36,10 @@ adc_mux pinToMux(pin_t pin);
 
 int16_t adc_read(adc_mux mux);
 
+/* Converts all the pins in one sequence, in place of one analogReadPin() each. Returns false,
+ * leaving values untouched, when they are on different ADCs or more than the sequence holds. */
+bool analogReadPins(const pin_t pins[], uint8_t count, uint16_t values[]);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,246 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Full duplex split transport on a USART, with separate TX and RX lines crossed between the halves.
+ *
+ * The frames, CRC and retries are in serial_duplex.c, this is its port on the ChibiOS UART driver.
+ * Both directions use DMA, the threads sleep until a transfer completes. The bytes that arrive
+ * while no reception is running, between the parts of a request, are kept by the character
+ * callback and handed to the next reception.
+ */
+
+#include <string.h>
+#include "quantum.h"
+#include "serial.h"
+#include "serial_duplex.h"
+
+#include "ch.h"
+#include "hal.h"
+
+#ifndef SERIAL_USART_DRIVER
+#    define SERIAL_USART_DRIVER UARTD1
+#endif
+
+#ifdef SOFT_SERIAL_PIN
+#    define SERIAL_USART_TX_PIN SOFT_SERIAL_PIN
+#endif
+
+#ifndef SERIAL_USART_RX_PIN
+#    error SERIAL_USART_RX_PIN has to be defined for the full duplex USART driver
+#endif
+
+#ifndef USE_GPIOV1
+#    ifndef SERIAL_USART_TX_PAL_MODE
+#        define SERIAL_USART_TX_PAL_MODE 7
+#    endif
+#    ifndef SERIAL_USART_RX_PAL_MODE
+#        define SERIAL_USART_RX_PAL_MODE SERIAL_USART_TX_PAL_MODE
+#    endif
+#endif
+
+// 8N1, damaged frames are caught by the CRC
+#ifndef SERIAL_USART_SPEED
+#    define SERIAL_USART_SPEED 1000000
+#endif
+
+#ifndef SERIAL_USART_CR1
+#    define SERIAL_USART_CR1 0
+#endif
+
+#ifndef SERIAL_USART_CR2
+#    define SERIAL_USART_CR2 0
+#endif
+
+#ifndef SERIAL_USART_CR3
+#    define SERIAL_USART_CR3 0
+#endif
+
+// ms to wait for a frame to be sent
+#define TX_TIMEOUT 100
+
+static binary_semaphore_t tx_done;
+static binary_semaphore_t rx_done;
+
+// the bytes received while no reception was running, enough for the time the slave thread takes
+// to start the next part of a request
+static uint8_t spill[8];
+static uint8_t spill_count;
+
+static void txend2(UARTDriver *uartp) {
+    (void)uartp;
+    chSysLockFromISR();
+    chBSemSignalI(&tx_done);
+    chSysUnlockFromISR();
+}
+
+static void rxend(UARTDriver *uartp) {
+    (void)uartp;
+    chSysLockFromISR();
+    chBSemSignalI(&rx_done);
+    chSysUnlockFromISR();
+}
+
+static void rxchar(UARTDriver *uartp, uint16_t c) {
+    (void)uartp;
+    chSysLockFromISR();
+    if (spill_count < sizeof(spill)) {
+        spill[spill_count++] = c;
+    }
+    chSysUnlockFromISR();
+}
+
+static UARTConfig uart_config = {
+    .txend1_cb = NULL,
+    .txend2_cb = txend2,
+    .rxend_cb  = rxend,
+    .rxchar_cb = rxchar,
+    .rxerr_cb  = NULL,
+    .speed     = SERIAL_USART_SPEED,
+    .cr1       = SERIAL_USART_CR1,
+    .cr2       = SERIAL_USART_CR2,
+    .cr3       = SERIAL_USART_CR3,
+};
+
+// Takes the spilled bytes first, and starts the DMA for the rest
+static void start_receive(uint8_t *rx, uint8_t size) {
+    chSysLock();
+    uint8_t count = spill_count < size ? spill_count : size;
+    memcpy(rx, spill, count);
+    memmove(spill, &spill[count], spill_count - count);
+    spill_count -= count;
+
+    chBSemResetI(&rx_done, true);
+    if (count < size) {
+        uartStartReceiveI(&SERIAL_USART_DRIVER, size - count, &rx[count]);
+    } else {
+        chBSemSignalI(&rx_done);
+    }
+    chSchRescheduleS();
+    chSysUnlock();
+}
+
+static bool wait_receive(uint16_t timeout) {
+    if (chBSemWaitTimeout(&rx_done, timeout ? TIME_MS2I(timeout) : TIME_INFINITE) == MSG_OK) {
+        return true;
+    }
+    uartStopReceive(&SERIAL_USART_DRIVER);
+    return false;
+}
+
+bool serial_duplex_port_send(const uint8_t *tx, uint8_t size) {
+    chBSemReset(&tx_done, true);
+    uartStartSend(&SERIAL_USART_DRIVER, size, tx);
+    if (chBSemWaitTimeout(&tx_done, TIME_MS2I(TX_TIMEOUT)) != MSG_OK) {
+        uartStopSend(&SERIAL_USART_DRIVER);
+        return false;
+    }
+    return true;
+}
+
+bool serial_duplex_port_receive(uint8_t *rx, uint8_t size, uint16_t timeout) {
+    start_receive(rx, size);
+    return wait_receive(timeout);
+}
+
+bool serial_duplex_port_exchange(const uint8_t *tx, uint8_t tx_size, uint8_t *rx, uint8_t rx_size, uint16_t timeout) {
+    // the response may start before the request has been sent completely
+    start_receive(rx, rx_size);
+    if (!serial_duplex_port_send(tx, tx_size)) {
+        uartStopReceive(&SERIAL_USART_DRIVER);
+        return false;
+    }
+    return wait_receive(timeout);
+}
+
+void serial_duplex_port_flush(void) {
+    chSysLock();
+    spill_count = 0;
+    chSysUnlock();
+}
+
+static SSTD_t *Transaction_table      = NULL;
+static uint8_t Transaction_table_size = 0;
+
+/*
+ * This thread runs on the slave and responds to transactions initiated
+ * by the master
+ */
+static THD_WORKING_AREA(waSlaveThread, 512);
+static THD_FUNCTION(SlaveThread, arg) {
+    (void)arg;
+    chRegSetThreadName("slave_transport");
+
+    while (true) {
+        serial_duplex_target_task(Transaction_table, Transaction_table_size);
+    }
+}
+
+__attribute__((weak)) void usart_init(void) {
+#if defined(USE_GPIOV1)
+    palSetLineMode(SERIAL_USART_TX_PIN, PAL_MODE_STM32_ALTERNATE_PUSHPULL);
+    palSetLineMode(SERIAL_USART_RX_PIN, PAL_MODE_INPUT_PULLUP);
+#else
+    palSetLineMode(SERIAL_USART_TX_PIN, PAL_MODE_ALTERNATE(SERIAL_USART_TX_PAL_MODE) | PAL_STM32_OTYPE_PUSHPULL);
+    palSetLineMode(SERIAL_USART_RX_PIN, PAL_MODE_ALTERNATE(SERIAL_USART_RX_PAL_MODE) | PAL_STM32_PUPDR_PULLUP);
+#endif
+}
+
+static void usart_start(void) {
+    usart_init();
+
+    chBSemObjectInit(&tx_done, true);
+    chBSemObjectInit(&rx_done, true);
+    uartStart(&SERIAL_USART_DRIVER, &uart_config);
+}
+
+void soft_serial_initiator_init(SSTD_t *sstd_table, int sstd_table_size) {
+    Transaction_table      = sstd_table;
+    Transaction_table_size = (uint8_t)sstd_table_size;
+
+    usart_start();
+}
+
+void soft_serial_target_init(SSTD_t *sstd_table, int sstd_table_size) {
+    Transaction_table      = sstd_table;
+    Transaction_table_size = (uint8_t)sstd_table_size;
+
+    usart_start();
+
+    // Start transport thread
+    chThdCreateStatic(waSlaveThread, sizeof(waSlaveThread), HIGHPRIO, SlaveThread, NULL);
+}
+
+/////////
+//  start transaction by initiator
+//
+// int  soft_serial_transaction(int sstd_index)
+//
+// Returns:
+//    TRANSACTION_END
+//    TRANSACTION_NO_RESPONSE
+//    TRANSACTION_DATA_ERROR
+//    TRANSACTION_TYPE_ERROR
+#ifndef SERIAL_USE_MULTI_TRANSACTION
+int soft_serial_transaction(void) {
+    uint8_t sstd_index = 0;
+#else
+int soft_serial_transaction(int index) {
+    uint8_t sstd_index = index;
+#endif
+
+    if (sstd_index >= Transaction_table_size) return TRANSACTION_TYPE_ERROR;
+    return serial_duplex_transaction(&Transaction_table[sstd_index], sstd_index);
+}
@@ -73,6 +73,14 @@ define GENERATE_MSG_MAKE_TEST
 endef
 MSG_MAKE_TEST = $(eval $(call GENERATE_MSG_MAKE_TEST))$(MSG_MAKE_TEST_ACTUAL)
 MSG_TEST = Testing $(BOLD)$(TEST_NAME)$(NO_COLOR)
+define GENERATE_MSG_MAKE_REPLAY
+    MSG_MAKE_REPLAY_ACTUAL := Making replay $(BOLD)$(REPLAY_NAME)$(NO_COLOR)
+    ifneq ($$(MAKE_TARGET),)
+        MSG_MAKE_REPLAY_ACTUAL += with target $(BOLD)$$(MAKE_TARGET)$(NO_COLOR)
+    endif
+endef
+MSG_MAKE_REPLAY = $(eval $(call GENERATE_MSG_MAKE_REPLAY))$(MSG_MAKE_REPLAY_ACTUAL)
+MSG_REPLAY = Replaying $(BOLD)$(TRACE)$(NO_COLOR) on $(BOLD)$(REPLAY_NAME)$(NO_COLOR)
 define GENERATE_MSG_AVAILABLE_KEYMAPS
     MSG_AVAILABLE_KEYMAPS_ACTUAL := Available keymaps for $(BOLD)$$(CURRENT_KB)$(NO_COLOR):
 endef
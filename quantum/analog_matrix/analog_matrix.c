@@ -0,0 +1,187 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "analog_matrix.h"
+
+#ifdef ANALOG_MATRIX_PINS
+#    include "analog.h"
+#endif
+
+#ifndef ANALOG_MATRIX_ACTUATION_POINT
+#    define ANALOG_MATRIX_ACTUATION_POINT 128
+#endif
+
+#ifndef ANALOG_MATRIX_RESET_POINT
+#    define ANALOG_MATRIX_RESET_POINT 100
+#endif
+
+#ifndef ANALOG_MATRIX_RAPID_TRIGGER
+#    define ANALOG_MATRIX_RAPID_TRIGGER 0
+#endif
+
+// the distance between rest and bottom-out, in sensor counts, until a deeper reading is seen
+#ifndef ANALOG_MATRIX_RANGE
+#    define ANALOG_MATRIX_RANGE 200
+#endif
+
+#ifndef ANALOG_MATRIX_CALIBRATION_SAMPLES
+#    define ANALOG_MATRIX_CALIBRATION_SAMPLES 16
+#endif
+
+#if ANALOG_MATRIX_RESET_POINT >= ANALOG_MATRIX_ACTUATION_POINT
+#    error ANALOG_MATRIX_RESET_POINT must be below ANALOG_MATRIX_ACTUATION_POINT
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+typedef struct {
+    uint16_t rest;     // calibrated reading at rest
+    uint16_t range;    // distance from rest of the deepest reading seen
+    uint16_t delta;    // distance from rest at the last read
+    uint16_t extreme;  // deepest distance while actuated, shallowest while reset by rapid trigger
+    uint8_t  actuation;
+    uint8_t  reset;
+    uint8_t  sensitivity;
+    bool     rapid;  // reset by rapid trigger, without going back above the reset point
+} analog_key_t;
+
+static analog_key_t keys[MATRIX_ROWS][MATRIX_COLS];
+
+#ifdef ANALOG_MATRIX_PINS
+static const pin_t analog_pins[MATRIX_ROWS][MATRIX_COLS] = ANALOG_MATRIX_PINS;
+
+__attribute__((weak)) void analog_matrix_sample_row(uint8_t row, uint16_t values[]) {
+#    ifdef PROTOCOL_CHIBIOS
+    // a single conversion of the row, unless its pins are spread over several ADCs
+    if (analogReadPins(analog_pins[row], MATRIX_COLS, values)) {
+        return;
+    }
+#    endif
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        pin_t pin   = analog_pins[row][col];
+        values[col] = pin == NO_PIN ? 0 : analogReadPin(pin);
+    }
+}
+#endif
+
+void analog_matrix_init(uint8_t num_rows) {
+    uint32_t sums[MATRIX_COLS];
+    uint16_t values[MATRIX_COLS];
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            sums[col] = 0;
+        }
+        for (uint8_t i = 0; i < ANALOG_MATRIX_CALIBRATION_SAMPLES; i++) {
+            analog_matrix_sample_row(row, values);
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                sums[col] += values[col];
+            }
+        }
+
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            keys[row][col] = (analog_key_t){
+                .rest        = sums[col] / ANALOG_MATRIX_CALIBRATION_SAMPLES,
+                .range       = ANALOG_MATRIX_RANGE,
+                .actuation   = ANALOG_MATRIX_ACTUATION_POINT,
+                .reset       = ANALOG_MATRIX_RESET_POINT,
+                .sensitivity = ANALOG_MATRIX_RAPID_TRIGGER,
+            };
+        }
+    }
+}
+
+void analog_matrix_set_actuation(uint8_t row, uint8_t col, uint8_t actuation, uint8_t reset, uint8_t sensitivity) {
+    keys[row][col].actuation   = actuation;
+    keys[row][col].reset       = reset;
+    keys[row][col].sensitivity = sensitivity;
+}
+
+uint8_t analog_matrix_get_travel(uint8_t row, uint8_t col) { return (uint32_t)keys[row][col].delta * 255 / keys[row][col].range; }
+
+/* Returns the new state of the key. Distances are compared to points as delta * 255 against
+ * range * point, which keeps divisions out of the scan. */
+static bool update_key(analog_key_t *key, uint16_t value, bool actuated) {
+    uint16_t delta = value > key->rest ? value - key->rest : key->rest - value;
+    if (delta > key->range) {
+        key->range = delta;
+    }
+    key->delta = delta;
+
+    uint32_t travel      = (uint32_t)delta * 255;
+    uint32_t reset       = (uint32_t)key->range * key->reset;
+    uint32_t sensitivity = (uint32_t)key->range * key->sensitivity;
+
+    if (actuated) {
+        if (delta > key->extreme) {
+            key->extreme = delta;
+        }
+        if (travel <= reset) {
+            key->rapid = false;
+            return false;
+        }
+        if (key->sensitivity && (uint32_t)(key->extreme - delta) * 255 >= sensitivity) {
+            key->rapid   = true;
+            key->extreme = delta;
+            return false;
+        }
+        return true;
+    }
+
+    if (travel <= reset) {
+        key->rapid = false;
+    }
+    if (key->rapid && key->sensitivity) {
+        // only the direction counts until the key rises to the reset point
+        if (delta < key->extreme) {
+            key->extreme = delta;
+        }
+        if ((uint32_t)(delta - key->extreme) * 255 >= sensitivity) {
+            key->extreme = delta;
+            return true;
+        }
+        return false;
+    }
+    if (travel >= (uint32_t)key->range * key->actuation) {
+        key->extreme = delta;
+        return true;
+    }
+    return false;
+}
+
+bool analog_matrix_read(matrix_row_t current_matrix[], uint8_t num_rows) {
+    bool     changed = false;
+    uint16_t values[MATRIX_COLS];
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t current_row_value = 0;
+
+        analog_matrix_sample_row(row, values);
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            bool actuated = current_matrix[row] & (ROW_SHIFTER << col);
+            if (update_key(&keys[row][col], values[col], actuated)) {
+                current_row_value |= ROW_SHIFTER << col;
+            }
+        }
+
+        if (current_matrix[row] != current_row_value) {
+            current_matrix[row] = current_row_value;
+            changed             = true;
+        }
+    }
+
+    return changed;
+}
@@ -0,0 +1,47 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Scans keys with analog (Hall-effect) sensors. The travel of each key is measured from its
+ * calibrated rest reading, in units of 0 at rest to 255 at the deepest reading seen so far.
+ * A key actuates at its actuation point and resets below its reset point, the hysteresis
+ * between them takes the place of debouncing. With rapid trigger a key also resets when it
+ * rises by the sensitivity from its deepest point, and actuates again when it then goes down
+ * by the sensitivity, anywhere above the reset point.
+ */
+
+/* Calibrates the rest readings, no key may be pressed */
+void analog_matrix_init(uint8_t num_rows);
+
+/* Reads the first num_rows rows, returns true if any key actuated or reset */
+bool analog_matrix_read(matrix_row_t current_matrix[], uint8_t num_rows);
+
+/* Points in travel units, a sensitivity of 0 disables rapid trigger for the key */
+void analog_matrix_set_actuation(uint8_t row, uint8_t col, uint8_t actuation, uint8_t reset, uint8_t sensitivity);
+
+/* The travel of the key at the last read */
+uint8_t analog_matrix_get_travel(uint8_t row, uint8_t col);
+
+/* The sample source, fills values with the current sensor readings of the row. The default
+ * converts the pins of the row of ANALOG_MATRIX_PINS together on ChibiOS, or one at a time
+ * with analogReadPin(). Keyboards sampling their sensors in the background, such as by
+ * circular DMA conversions, return their latest samples instead. */
+void analog_matrix_sample_row(uint8_t row, uint16_t values[]);
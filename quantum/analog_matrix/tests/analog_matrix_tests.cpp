@@ -0,0 +1,150 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdint>
+#include <random>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "analog_matrix.h"
+}
+
+// the mocked ADC: the rest reading of every key, how the reading moves with travel and noise
+static uint16_t     rest_values[MATRIX_ROWS][MATRIX_COLS];
+static int16_t      polarity[MATRIX_ROWS][MATRIX_COLS];
+static uint16_t     depth[MATRIX_ROWS][MATRIX_COLS];  // sensor counts from rest
+static uint16_t     noise;
+static std::mt19937 rng;
+
+extern "C" void analog_matrix_sample_row(uint8_t row, uint16_t values[]) {
+    std::uniform_int_distribution<int> n(-(int)noise, noise);
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        values[col] = rest_values[row][col] + polarity[row][col] * depth[row][col] + (noise ? n(rng) : 0);
+    }
+}
+
+class AnalogMatrix : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        rng.seed(1);
+        noise = 0;
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                // sensors differ in their rest reading and half of them read lower when pressed
+                rest_values[row][col] = 2000 + 37 * row - 23 * col;
+                polarity[row][col]    = (row + col) % 2 ? -1 : 1;
+                depth[row][col]       = 0;
+            }
+        }
+        analog_matrix_init(MATRIX_ROWS);
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            current_matrix[row] = 0;
+        }
+    }
+
+    /* moves the key to travel units out of the ANALOG_MATRIX_RANGE of the test, and scans */
+    bool move(uint8_t row, uint8_t col, uint8_t travel) {
+        depth[row][col] = (uint32_t)travel * ANALOG_MATRIX_RANGE / 255;
+        return analog_matrix_read(current_matrix, MATRIX_ROWS);
+    }
+
+    bool actuated(uint8_t row, uint8_t col) { return current_matrix[row] & ((matrix_row_t)1 << col); }
+
+    matrix_row_t current_matrix[MATRIX_ROWS];
+};
+
+TEST_F(AnalogMatrix, ActuatesOnTheScanThatCrossesTheActuationPoint) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            EXPECT_FALSE(move(row, col, ANALOG_MATRIX_ACTUATION_POINT - 3));
+            EXPECT_TRUE(move(row, col, ANALOG_MATRIX_ACTUATION_POINT + 3));
+            EXPECT_TRUE(actuated(row, col));
+            EXPECT_FALSE(move(row, col, ANALOG_MATRIX_RESET_POINT + 3));
+            EXPECT_TRUE(move(row, col, ANALOG_MATRIX_RESET_POINT - 3));
+            EXPECT_FALSE(actuated(row, col));
+        }
+    }
+}
+
+TEST_F(AnalogMatrix, HysteresisIgnoresNoise) {
+    // less noise than the distance between the points, around the actuation point
+    noise            = (ANALOG_MATRIX_ACTUATION_POINT - ANALOG_MATRIX_RESET_POINT) * ANALOG_MATRIX_RANGE / 255 / 3;
+    uint32_t changes = 0;
+    uint8_t  points[] = {0, ANALOG_MATRIX_ACTUATION_POINT, ANALOG_MATRIX_ACTUATION_POINT + 2, ANALOG_MATRIX_ACTUATION_POINT - 2, ANALOG_MATRIX_RESET_POINT + 12};
+    for (uint8_t point : points) {
+        for (int i = 0; i < 100; i++) {
+            changes += move(1, 2, point);
+        }
+    }
+    EXPECT_EQ(changes, 1);
+    EXPECT_TRUE(actuated(1, 2));
+}
+
+TEST_F(AnalogMatrix, RapidTriggerResetsAndActuatesOnDirection) {
+    analog_matrix_set_actuation(0, 1, ANALOG_MATRIX_ACTUATION_POINT, ANALOG_MATRIX_RESET_POINT, 20);
+
+    EXPECT_TRUE(move(0, 1, 220));
+    // rising by less than the sensitivity keeps it actuated, the deepest point counts
+    EXPECT_FALSE(move(0, 1, 240));
+    EXPECT_FALSE(move(0, 1, 225));
+    EXPECT_TRUE(move(0, 1, 215));
+    EXPECT_FALSE(actuated(0, 1));
+    // it actuates again going down from its shallowest point, above the actuation point or not
+    EXPECT_FALSE(move(0, 1, 180));
+    EXPECT_FALSE(move(0, 1, 110));
+    EXPECT_TRUE(move(0, 1, 135));
+    EXPECT_TRUE(actuated(0, 1));
+    EXPECT_TRUE(move(0, 1, 112));
+    EXPECT_FALSE(actuated(0, 1));
+
+    // once it rose to the reset point it needs the actuation point again
+    EXPECT_FALSE(move(0, 1, ANALOG_MATRIX_RESET_POINT - 1));
+    EXPECT_FALSE(move(0, 1, ANALOG_MATRIX_ACTUATION_POINT - 3));
+    EXPECT_TRUE(move(0, 1, ANALOG_MATRIX_ACTUATION_POINT + 3));
+}
+
+TEST_F(AnalogMatrix, WithoutRapidTriggerOnlyTheResetPointResets) {
+    EXPECT_TRUE(move(0, 1, 220));
+    EXPECT_FALSE(move(0, 1, 150));
+    EXPECT_FALSE(move(0, 1, 240));
+    EXPECT_TRUE(actuated(0, 1));
+}
+
+TEST_F(AnalogMatrix, PerKeyActuationPoints) {
+    analog_matrix_set_actuation(2, 3, 40, 20, 0);
+    EXPECT_TRUE(move(2, 3, 45));
+    EXPECT_FALSE(move(2, 2, 45));
+    EXPECT_TRUE(actuated(2, 3));
+}
+
+TEST_F(AnalogMatrix, RangeFollowsTheDeepestReading) {
+    EXPECT_TRUE(move(0, 0, 255));
+    EXPECT_EQ(analog_matrix_get_travel(0, 0), 255);
+    // a switch that goes twice as deep as expected halves the travel of every reading
+    depth[0][0] = 2 * ANALOG_MATRIX_RANGE;
+    EXPECT_FALSE(analog_matrix_read(current_matrix, MATRIX_ROWS));
+    EXPECT_EQ(analog_matrix_get_travel(0, 0), 255);
+    EXPECT_TRUE(move(0, 0, 200));
+    EXPECT_FALSE(actuated(0, 0));
+    EXPECT_NEAR(analog_matrix_get_travel(0, 0), 100, 1);
+}
+
+TEST_F(AnalogMatrix, ReadsOnlyTheRowsOfThisHalf) {
+    depth[MATRIX_ROWS - 1][0]       = ANALOG_MATRIX_RANGE;
+    current_matrix[MATRIX_ROWS - 1] = 0x5;
+    EXPECT_FALSE(analog_matrix_read(current_matrix, MATRIX_ROWS - 1));
+    EXPECT_EQ(current_matrix[MATRIX_ROWS - 1], 0x5);
+}
@@ -0,0 +1,5 @@
+analog_matrix_DEFS := -DMATRIX_ROWS=3 -DMATRIX_COLS=4 -DANALOG_MATRIX_RANGE=400 -DANALOG_MATRIX_ACTUATION_POINT=128 -DANALOG_MATRIX_RESET_POINT=100
+analog_matrix_SRC :=\
+	$(QUANTUM_PATH)/analog_matrix/tests/analog_matrix_tests.cpp \
+	$(QUANTUM_PATH)/analog_matrix/analog_matrix.c
+analog_matrix_INC := $(QUANTUM_PATH)/analog_matrix
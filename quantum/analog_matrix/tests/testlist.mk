@@ -0,0 +1,2 @@
+TEST_LIST +=\
+	analog_matrix
\ No newline at end of file
@@ -40,6 +40,9 @@ void            debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_
         }
         debouncing = false;
     }
+    if (debouncing) {
+        timer_deadline(debouncing_time + DEBOUNCE + 1);
+    }
 }
 #else  // no debouncing.
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
@@ -33,6 +33,7 @@ When no state changes have occured for DEBOUNCE milliseconds, we push the state.
 
 static debounce_counter_t *debounce_counters;
 static bool                counters_need_update;
+static uint8_t             next_expiry;  // time left until the first counter expires
 
 #define DEBOUNCE_ELAPSED 251
 #define MAX_DEBOUNCE (DEBOUNCE_ELAPSED - 1)
@@ -63,6 +64,7 @@ void debounce_init(uint8_t num_rows) {
 
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
     uint8_t current_time = wrapping_timer_read();
+    next_expiry          = DEBOUNCE;
     if (counters_need_update) {
         update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, current_time);
     }
@@ -70,6 +72,9 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     if (changed) {
         start_debounce_counters(raw, cooked, num_rows, current_time);
     }
+    if (counters_need_update) {
+        timer_deadline(timer_read() + next_expiry);
+    }
 }
 
 void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t current_time) {
@@ -78,11 +83,15 @@ void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix
     for (uint8_t row = 0; row < num_rows; row++) {
         for (uint8_t col = 0; col < MATRIX_COLS; col++) {
             if (*debounce_pointer != DEBOUNCE_ELAPSED) {
-                if (TIMER_DIFF(current_time, *debounce_pointer, MAX_DEBOUNCE) >= DEBOUNCE) {
+                uint8_t elapsed = TIMER_DIFF(current_time, *debounce_pointer, MAX_DEBOUNCE);
+                if (elapsed >= DEBOUNCE) {
                     *debounce_pointer = DEBOUNCE_ELAPSED;
                     cooked[row]       = (cooked[row] & ~(ROW_SHIFTER << col)) | (raw[row] & (ROW_SHIFTER << col));
                 } else {
                     counters_need_update = true;
+                    if (DEBOUNCE - elapsed < next_expiry) {
+                        next_expiry = DEBOUNCE - elapsed;
+                    }
                 }
             }
             debounce_pointer++;
@@ -0,0 +1,132 @@
+/*
+Copyright 2020 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Symmetric per-key algorithm using vertical counters.
+Same behaviour as sym_defer_pk: when no state changes have occured on a key for DEBOUNCE
+milliseconds, we push the state of that key.
+Instead of a byte per key, bit b of every key's counter is stored in counters[b][row], so
+a whole row is counted and compared with a few bitwise operations, however wide it is.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+#if DEBOUNCE > 0
+
+#    if DEBOUNCE < 2
+#        define COUNTER_BITS 1
+#    elif DEBOUNCE < 4
+#        define COUNTER_BITS 2
+#    elif DEBOUNCE < 8
+#        define COUNTER_BITS 3
+#    elif DEBOUNCE < 16
+#        define COUNTER_BITS 4
+#    elif DEBOUNCE < 32
+#        define COUNTER_BITS 5
+#    elif DEBOUNCE < 64
+#        define COUNTER_BITS 6
+#    elif DEBOUNCE < 128
+#        define COUNTER_BITS 7
+#    elif DEBOUNCE < 256
+#        define COUNTER_BITS 8
+#    else
+#        error DEBOUNCE must be below 256 for sym_defer_vc
+#    endif
+
+// MATRIX_ROWS is the size of the whole keyboard, so this also fits both halves of a split keyboard
+static matrix_row_t counters[COUNTER_BITS][MATRIX_ROWS];
+static matrix_row_t counting[MATRIX_ROWS];
+static uint16_t     last_time;
+static bool         counters_need_update;
+
+void debounce_init(uint8_t num_rows) { last_time = timer_read(); }
+
+/** \brief Advance the counters of the keys in active by one millisecond
+ *
+ * Returns the keys whose counter reached DEBOUNCE, their counters are cleared.
+ */
+static matrix_row_t tick_counters(uint8_t row, matrix_row_t active) {
+    matrix_row_t carry   = active;
+    matrix_row_t expired = active;
+    for (uint8_t b = 0; b < COUNTER_BITS; b++) {
+        matrix_row_t bit = counters[b][row];
+        counters[b][row] = bit ^ carry;
+        carry            = bit & carry;
+        expired &= (DEBOUNCE & (1 << b)) ? counters[b][row] : ~counters[b][row];
+    }
+    if (expired) {
+        for (uint8_t b = 0; b < COUNTER_BITS; b++) {
+            counters[b][row] &= ~expired;
+        }
+    }
+    return expired;
+}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint16_t elapsed = timer_elapsed(last_time);
+    last_time += elapsed;
+    if (elapsed > DEBOUNCE) {
+        elapsed = DEBOUNCE;
+    }
+
+    if (!counters_need_update && !changed) {
+        return;
+    }
+
+    counters_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta  = raw[row] ^ cooked[row];
+        matrix_row_t active = counting[row] & delta;
+
+        // keys that went back to their debounced state stop counting
+        for (uint8_t b = 0; b < COUNTER_BITS; b++) {
+            counters[b][row] &= active;
+        }
+        for (uint16_t t = 0; t < elapsed && active; t++) {
+            matrix_row_t expired = tick_counters(row, active);
+            cooked[row] ^= expired;
+            active &= ~expired;
+        }
+
+        // new changes start counting from this scan
+        counting[row] = active | (delta & ~counting[row]);
+        if (counting[row]) {
+            counters_need_update = true;
+        }
+    }
+
+    if (counters_need_update) {
+        timer_deadline(last_time + 1);
+    }
+}
+
+bool debounce_active(void) { return counters_need_update; }
+
+#else  // no debouncing.
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    for (int i = 0; i < num_rows; i++) {
+        cooked[i] = raw[i];
+    }
+}
+
+bool debounce_active(void) { return false; }
+#endif
@@ -0,0 +1,128 @@
+/*
+Copyright 2020 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Per-key eager algorithm, same behaviour as sym_eager_pk.
+Instead of a counter for every key, only the keys that are currently locked are kept,
+in a statically allocated list of DEBOUNCE_LIST_SIZE entries, so the work per scan depends
+on the number of keys in motion rather than on the size of the matrix.
+When the list is full, new changes wait for a free entry before they are pushed.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+#include "util.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+#ifndef DEBOUNCE_LIST_SIZE
+#    define DEBOUNCE_LIST_SIZE 16
+#endif
+
+#if DEBOUNCE_LIST_SIZE > 255
+#    error DEBOUNCE_LIST_SIZE must be below 256
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+#define MAX_DEBOUNCE 250
+
+typedef struct {
+    uint8_t row;
+    uint8_t col;
+    uint8_t time;
+} debounce_entry_t;
+
+static debounce_entry_t debounce_list[DEBOUNCE_LIST_SIZE];
+static uint8_t          debounce_count;
+static uint8_t          next_expiry;  // time left until the first entry expires
+// the keys that have an entry in debounce_list
+static matrix_row_t debouncing[MATRIX_ROWS];
+static bool         matrix_need_update;
+
+static uint8_t wrapping_timer_read(void) {
+    static uint16_t time        = 0;
+    static uint8_t  last_result = 0;
+    uint16_t        new_time    = timer_read();
+    uint16_t        diff        = new_time - time;
+    time                        = new_time;
+    last_result                 = (last_result + diff) % (MAX_DEBOUNCE + 1);
+    return last_result;
+}
+
+void update_debounce_list(uint8_t current_time);
+void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t current_time);
+
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint8_t current_time = wrapping_timer_read();
+    next_expiry          = DEBOUNCE;
+    if (debounce_count) {
+        update_debounce_list(current_time);
+    }
+
+    if (changed || matrix_need_update) {
+        transfer_matrix_values(raw, cooked, num_rows, current_time);
+    }
+    if (debounce_count) {
+        timer_deadline(timer_read() + next_expiry);
+    }
+}
+
+// Remove the keys whose lock has expired, to enable input.
+void update_debounce_list(uint8_t current_time) {
+    uint8_t i = 0;
+    while (i < debounce_count) {
+        debounce_entry_t *entry   = &debounce_list[i];
+        uint8_t           elapsed = TIMER_DIFF(current_time, entry->time, MAX_DEBOUNCE);
+        if (elapsed >= DEBOUNCE) {
+            debouncing[entry->row] &= ~(ROW_SHIFTER << entry->col);
+            *entry = debounce_list[--debounce_count];
+        } else {
+            if (DEBOUNCE - elapsed < next_expiry) {
+                next_expiry = DEBOUNCE - elapsed;
+            }
+            i++;
+        }
+    }
+}
+
+// upload from raw_matrix to final matrix;
+void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t current_time) {
+    matrix_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+        if (delta & debouncing[row]) {
+            matrix_need_update = true;
+        }
+        delta &= ~debouncing[row];
+        while (delta) {
+            if (debounce_count == DEBOUNCE_LIST_SIZE) {
+                matrix_need_update = true;
+                break;
+            }
+            matrix_row_t col_mask = delta & -delta;
+            delta &= ~col_mask;
+            cooked[row] ^= col_mask;  // flip the bit.
+            debouncing[row] |= col_mask;
+            debounce_list[debounce_count++] = (debounce_entry_t){.row = row, .col = biton32(col_mask), .time = current_time};
+        }
+    }
+}
+
+bool debounce_active(void) { return true; }
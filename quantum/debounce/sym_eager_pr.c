@@ -32,6 +32,7 @@ static bool matrix_need_update;
 
 static debounce_counter_t *debounce_counters;
 static bool                counters_need_update;
+static uint8_t             next_expiry;  // time left until the first counter expires
 
 #define DEBOUNCE_ELAPSED 251
 #define MAX_DEBOUNCE (DEBOUNCE_ELAPSED - 1)
@@ -60,6 +61,7 @@ void debounce_init(uint8_t num_rows) {
 void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
     uint8_t current_time  = wrapping_timer_read();
     bool    needed_update = counters_need_update;
+    next_expiry           = DEBOUNCE;
     if (counters_need_update) {
         update_debounce_counters(num_rows, current_time);
     }
@@ -67,6 +69,9 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     if (changed || (needed_update && !counters_need_update) || matrix_need_update) {
         transfer_matrix_values(raw, cooked, num_rows, current_time);
     }
+    if (counters_need_update) {
+        timer_deadline(timer_read() + next_expiry);
+    }
 }
 
 // If the current time is > debounce counter, set the counter to enable input.
@@ -75,10 +80,14 @@ void update_debounce_counters(uint8_t num_rows, uint8_t current_time) {
     debounce_counter_t *debounce_pointer = debounce_counters;
     for (uint8_t row = 0; row < num_rows; row++) {
         if (*debounce_pointer != DEBOUNCE_ELAPSED) {
-            if (TIMER_DIFF(current_time, *debounce_pointer, MAX_DEBOUNCE) >= DEBOUNCE) {
+            uint8_t elapsed = TIMER_DIFF(current_time, *debounce_pointer, MAX_DEBOUNCE);
+            if (elapsed >= DEBOUNCE) {
                 *debounce_pointer = DEBOUNCE_ELAPSED;
             } else {
                 counters_need_update = true;
+                if (DEBOUNCE - elapsed < next_expiry) {
+                    next_expiry = DEBOUNCE - elapsed;
+                }
             }
         }
         debounce_pointer++;
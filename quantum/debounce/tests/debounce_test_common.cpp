@@ -0,0 +1,238 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "debounce_test_common.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+extern "C" {
+#include "debounce.h"
+#include "timer.h"
+
+void advance_time_us(uint32_t us);
+bool get_next_deadline(uint32_t *us);
+void clear_deadline(void);
+}
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+void LatencyStats::add(uint32_t us) {
+    count++;
+    total += us;
+    max_us = std::max(max_us, us);
+}
+
+void DebounceTest::SetUp() {
+    memset(raw, 0, sizeof(raw));
+    memset(cooked, 0, sizeof(cooked));
+    rng.seed(1);
+    scans = 0;
+    debounce_init(MATRIX_ROWS);
+}
+
+void DebounceTest::add_event(uint32_t time_us, uint8_t row, uint8_t col, bool pressed) { events.push_back({time_us, row, col, pressed}); }
+
+void DebounceTest::add_keystroke(const KeyStroke &stroke) {
+    strokes.push_back(stroke);
+    add_event(stroke.press_us, stroke.row, stroke.col, true);
+    for (size_t i = 0; i < stroke.press_bounce.size(); i++) {
+        add_event(stroke.press_us + stroke.press_bounce[i], stroke.row, stroke.col, i % 2);
+    }
+    add_event(stroke.release_us, stroke.row, stroke.col, false);
+    for (size_t i = 0; i < stroke.release_bounce.size(); i++) {
+        add_event(stroke.release_us + stroke.release_bounce[i], stroke.row, stroke.col, !(i % 2));
+    }
+}
+
+void DebounceTest::add_keystroke(uint8_t row, uint8_t col, uint32_t press_us, uint32_t hold_us, uint32_t bounce_us, uint8_t chatter) {
+    KeyStroke stroke = {row, col, press_us, press_us + hold_us, {}, {}};
+    if (bounce_us > 1) {
+        std::uniform_int_distribution<uint32_t> offset(1, bounce_us - 1);
+        for (uint8_t i = 0; i < 2 * chatter; i++) {
+            stroke.press_bounce.push_back(offset(rng));
+            stroke.release_bounce.push_back(offset(rng));
+        }
+        std::sort(stroke.press_bounce.begin(), stroke.press_bounce.end());
+        std::sort(stroke.release_bounce.begin(), stroke.release_bounce.end());
+    }
+    add_keystroke(stroke);
+}
+
+void DebounceTest::add_random_keystrokes(uint32_t count, uint32_t max_bounce_us, uint8_t max_chatter, uint32_t min_gap_us) {
+    std::uniform_int_distribution<uint32_t> key(0, MATRIX_ROWS * MATRIX_COLS - 1);
+    std::uniform_int_distribution<uint32_t> gap(0, 40000);
+    std::uniform_int_distribution<uint32_t> hold(0, 60000);
+    std::uniform_int_distribution<uint32_t> bounce(0, max_bounce_us);
+    std::uniform_int_distribution<uint32_t> chatter(0, max_chatter);
+
+    std::vector<uint32_t> key_free(MATRIX_ROWS * MATRIX_COLS, 0);
+    std::vector<uint32_t> edges;
+    uint32_t              time = 10000;
+
+    auto far_from_edges = [&](uint32_t t) {
+        for (uint32_t edge : edges) {
+            if ((t > edge ? t - edge : edge - t) < min_gap_us) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    while (count) {
+        time += gap(rng);
+        uint32_t k = key(rng);
+        uint32_t b = bounce(rng);
+        // the press has to be debounced before the release starts
+        uint32_t h = b + (DEBOUNCE + 2) * 1000 + hold(rng);
+        if (key_free[k] > time || !far_from_edges(time) || !far_from_edges(time + h)) {
+            continue;
+        }
+        add_keystroke(k / MATRIX_COLS, k % MATRIX_COLS, time, h, b, chatter(rng));
+        edges.push_back(time);
+        edges.push_back(time + h);
+        key_free[k] = time + h + b + (DEBOUNCE + 2) * 1000;
+        count--;
+    }
+}
+
+void DebounceTest::scan(uint32_t now, size_t &next) {
+    bool changed = false;
+    for (; next < events.size() && events[next].time_us <= now; next++) {
+        const KeyEvent &event = events[next];
+        matrix_row_t    bit   = (matrix_row_t)1 << event.col;
+        if (!(raw[event.row] & bit) != !event.pressed) {
+            raw[event.row] ^= bit;
+            changed = true;
+        }
+    }
+
+    matrix_row_t before[MATRIX_ROWS];
+    memcpy(before, cooked, sizeof(cooked));
+
+    scan_raw.insert(scan_raw.end(), raw, raw + MATRIX_ROWS);
+    scan_changed.push_back(changed);
+    clear_deadline();
+    debounce(raw, cooked, MATRIX_ROWS, changed);
+    scans++;
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        matrix_row_t delta = before[row] ^ cooked[row];
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (delta & ((matrix_row_t)1 << col)) {
+                cooked_events.push_back({now, row, col, (bool)(cooked[row] & ((matrix_row_t)1 << col))});
+            }
+        }
+    }
+}
+
+void DebounceTest::check_settled(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        EXPECT_EQ(cooked[row], raw[row]) << "row " << (int)row << " did not settle";
+    }
+}
+
+void DebounceTest::run(uint32_t scan_interval_us) {
+    std::stable_sort(events.begin(), events.end(), [](const KeyEvent &a, const KeyEvent &b) { return a.time_us < b.time_us; });
+
+    uint32_t end  = (events.empty() ? 0 : events.back().time_us) + 2 * (DEBOUNCE + 2) * 1000;
+    size_t   next = 0;
+
+    for (uint32_t now = 0; now <= end; now += scan_interval_us) {
+        scan(now, next);
+        advance_time_us(scan_interval_us);
+    }
+    check_settled();
+}
+
+void DebounceTest::run_to_deadlines(bool every_ms) {
+    std::stable_sort(events.begin(), events.end(), [](const KeyEvent &a, const KeyEvent &b) { return a.time_us < b.time_us; });
+    // start on a millisecond, so that runs with the same events see the same timer_read() values
+    if (timer_read_us() % 1000) {
+        advance_time_us(1000 - timer_read_us() % 1000);
+    }
+
+    uint32_t end  = (events.empty() ? 0 : events.back().time_us) + 2 * (DEBOUNCE + 2) * 1000;
+    size_t   next = 0;
+
+    for (uint32_t now = 0; now <= end;) {
+        scan(now, next);
+
+        uint32_t until = next < events.size() ? events[next].time_us : end + 1;
+        uint32_t deadline;
+        if (every_ms) {
+            until = std::min(until, now + 1000 - now % 1000);
+        } else if (get_next_deadline(&deadline)) {
+            until = std::min(until, now + std::max<uint32_t>(deadline, 1));
+        }
+        advance_time_us(until - now);
+        now = until;
+    }
+    check_settled();
+}
+
+double DebounceTest::ns_per_scan(uint32_t scan_interval_us) {
+    matrix_row_t replay_cooked[MATRIX_ROWS];
+    memcpy(replay_cooked, cooked, sizeof(cooked));
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < scan_changed.size(); i++) {
+        debounce(&scan_raw[i * MATRIX_ROWS], replay_cooked, MATRIX_ROWS, scan_changed[i]);
+        advance_time_us(scan_interval_us);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return scan_changed.empty() ? 0 : (double)elapsed / scan_changed.size();
+}
+
+void DebounceTest::check_keystrokes(void) {
+    std::vector<const KeyStroke *> sorted;
+    for (const KeyStroke &stroke : strokes) {
+        sorted.push_back(&stroke);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const KeyStroke *a, const KeyStroke *b) { return a->press_us < b->press_us; });
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            std::vector<const KeyStroke *> key_strokes;
+            std::vector<const KeyEvent *>  key_events;
+            for (const KeyStroke *stroke : sorted) {
+                if (stroke->row == row && stroke->col == col) {
+                    key_strokes.push_back(stroke);
+                }
+            }
+            for (const KeyEvent &event : cooked_events) {
+                if (event.row == row && event.col == col) {
+                    key_events.push_back(&event);
+                }
+            }
+
+            ASSERT_EQ(key_events.size(), 2 * key_strokes.size()) << "key " << (int)row << "," << (int)col;
+            for (size_t i = 0; i < key_strokes.size(); i++) {
+                const KeyEvent *press   = key_events[2 * i];
+                const KeyEvent *release = key_events[2 * i + 1];
+                EXPECT_TRUE(press->pressed);
+                EXPECT_FALSE(release->pressed);
+                ASSERT_GE(press->time_us, key_strokes[i]->press_us);
+                ASSERT_LT(press->time_us, key_strokes[i]->release_us);
+                ASSERT_GE(release->time_us, key_strokes[i]->release_us);
+                press_latency.add(press->time_us - key_strokes[i]->press_us);
+                release_latency.add(release->time_us - key_strokes[i]->release_us);
+            }
+        }
+    }
+}
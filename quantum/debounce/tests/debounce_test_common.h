@@ -0,0 +1,103 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix.h"
+}
+
+/* A change of the state of one key, times are in microseconds */
+struct KeyEvent {
+    uint32_t time_us;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed;
+};
+
+/* One key press and release. The bounce offsets are extra toggles of the raw state after the press
+ * and after the release, relative to them and in increasing order. There must be an even number of
+ * them, so that the key ends up in the intended state.
+ */
+struct KeyStroke {
+    uint8_t               row;
+    uint8_t               col;
+    uint32_t              press_us;
+    uint32_t              release_us;
+    std::vector<uint32_t> press_bounce;
+    std::vector<uint32_t> release_bounce;
+};
+
+struct LatencyStats {
+    uint32_t count  = 0;
+    uint64_t total  = 0;
+    uint32_t max_us = 0;
+
+    void     add(uint32_t us);
+    uint32_t avg_us(void) const { return count ? total / count : 0; }
+};
+
+/* Plays raw key events through debounce() and records the changes of the debounced matrix.
+ *
+ * The matrix is scanned every scan_interval_us of simulated time. Events are applied before the
+ * first scan at or after their time, so an event on a scan boundary has a latency of 0 with an
+ * eager algorithm.
+ */
+class DebounceTest : public ::testing::Test {
+   protected:
+    void SetUp() override;
+
+    void add_event(uint32_t time_us, uint8_t row, uint8_t col, bool pressed);
+    void add_keystroke(const KeyStroke &stroke);
+    /* a key stroke with chatter toggle pairs spread randomly over bounce_us after each edge */
+    void add_keystroke(uint8_t row, uint8_t col, uint32_t press_us, uint32_t hold_us, uint32_t bounce_us, uint8_t chatter);
+    /* count random key strokes, bounces of up to max_bounce_us, edges at least min_gap_us apart */
+    void add_random_keystrokes(uint32_t count, uint32_t max_bounce_us, uint8_t max_chatter, uint32_t min_gap_us);
+
+    /* scans until all events have been played and the matrix has settled */
+    void run(uint32_t scan_interval_us = 1000);
+    /* like run(), but only scans at the events and at the deadlines debounce() registers with
+     * timer_deadline(), the way idle time is skipped by the keyboard tests, or with every_ms at
+     * every millisecond in between as well */
+    void run_to_deadlines(bool every_ms = false);
+    /* checks that every stroke was debounced into exactly one press and one release */
+    void check_keystrokes(void);
+    /* plays the scans of run() again, which has to end with the keys in the state they started
+     * in, and returns the average host time debounce() took */
+    double ns_per_scan(uint32_t scan_interval_us);
+
+    std::vector<KeyEvent>  events;
+    std::vector<KeyStroke> strokes;
+    std::vector<KeyEvent>  cooked_events;
+    LatencyStats           press_latency;
+    LatencyStats           release_latency;
+    uint32_t               scans;
+    std::mt19937           rng;
+
+   private:
+    void scan(uint32_t now, size_t &next);
+    void check_settled(void);
+
+    matrix_row_t              raw[MATRIX_ROWS];
+    matrix_row_t              cooked[MATRIX_ROWS];
+    std::vector<matrix_row_t> scan_raw;
+    std::vector<bool>         scan_changed;
+};
@@ -0,0 +1,169 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* These tests are built once for every debounce algorithm, see rules.mk. The algorithm is
+ * described by DEBOUNCE_EAGER_PRESS and DEBOUNCE_EAGER_RELEASE, for algorithms that report that
+ * edge immediately, and DEBOUNCE_GLOBAL, for algorithms that wait for the whole matrix to settle.
+ */
+
+#include "debounce_test_common.h"
+#include <cstdio>
+
+#define XSTR(s) STR(s)
+#define STR(s) #s
+
+#ifdef DEBOUNCE_GLOBAL
+// edges closer than this hold each other back
+#    define MIN_EDGE_GAP_US ((DEBOUNCE + 2) * 1000 + MAX_BOUNCE_US)
+#else
+#    define MIN_EDGE_GAP_US 0
+#endif
+
+// eager algorithms only ignore bounce up to DEBOUNCE after the first edge
+#define MAX_BOUNCE_US ((DEBOUNCE - 1) * 1000)
+
+#ifdef DEBOUNCE_EAGER_PRESS
+#    define PRESS_LATENCY_US 0
+#else
+#    define PRESS_LATENCY_US (DEBOUNCE * 1000)
+#endif
+
+#ifdef DEBOUNCE_EAGER_RELEASE
+#    define RELEASE_LATENCY_US 0
+#else
+#    define RELEASE_LATENCY_US (DEBOUNCE * 1000)
+#endif
+
+// sym_defer_g waits for more than DEBOUNCE ms
+#define LATENCY_SLACK_US 1000
+
+#ifdef DEBOUNCE_TICKS
+// the counters count the milliseconds of a change one scan at a time
+#    define SCANS_PER_EDGE DEBOUNCE
+#else
+#    define SCANS_PER_EDGE 1
+#endif
+
+class Debounce : public DebounceTest {};
+
+TEST_F(Debounce, CleanKeyStroke) {
+    add_keystroke(0, 0, 10000, 50000, 0, 0);
+    run();
+    check_keystrokes();
+    EXPECT_GE(press_latency.max_us, PRESS_LATENCY_US);
+    EXPECT_LE(press_latency.max_us, PRESS_LATENCY_US + LATENCY_SLACK_US);
+    EXPECT_GE(release_latency.max_us, RELEASE_LATENCY_US);
+    EXPECT_LE(release_latency.max_us, RELEASE_LATENCY_US + LATENCY_SLACK_US);
+}
+
+TEST_F(Debounce, BouncingKeyStroke) {
+    add_keystroke({2, 7, 10000, 50000, {1000, 2000, 3000, 4000}, {1000, 3000}});
+    run();
+    check_keystrokes();
+#ifndef DEBOUNCE_EAGER_PRESS
+    // the press settles with the last bounce
+    EXPECT_GE(press_latency.max_us, 4000 + PRESS_LATENCY_US);
+#else
+    EXPECT_EQ(press_latency.max_us, 0);
+#endif
+}
+
+TEST_F(Debounce, SimultaneousKeyStrokes) {
+    // the same row, the same column and a different row and column
+    add_keystroke(1, 1, 10000, 40000, 3000, 2);
+    add_keystroke(1, 2, 10000, 40000, 3000, 2);
+    add_keystroke(2, 1, 10000, 40000, 3000, 2);
+    add_keystroke(3, 9, 10000, 40000, 3000, 2);
+    run(250);
+    check_keystrokes();
+}
+
+TEST_F(Debounce, ReferenceWaveforms) {
+    // in the shape of scope captures: a clean switch, a long ringing press and a worn switch
+    // chattering on release
+    add_keystroke({0, 3, 10000, 50000, {80, 120}, {}});
+    add_keystroke({1, 4, 100000, 160000, {150, 310, 500, 900, 1300, 1400, 2100, 2300}, {40, 90}});
+    add_keystroke({2, 5, 200000, 250000, {30, 70}, {700, 1500, 1600, 2700, 2750, 3600}});
+    run(100);
+    check_keystrokes();
+}
+
+#ifndef DEBOUNCE_EAGER_PRESS
+TEST_F(Debounce, NoiseIsIgnored) {
+    add_event(10000, 0, 0, true);
+    add_event(10400, 0, 0, false);
+    add_event(20000, 3, 9, true);
+    add_event(21000, 3, 9, false);
+    run(100);
+    EXPECT_TRUE(cooked_events.empty());
+}
+#else
+TEST_F(Debounce, NoiseIsReportedOnce) {
+    add_event(10000, 0, 0, true);
+    add_event(10400, 0, 0, false);
+    run(100);
+    ASSERT_EQ(cooked_events.size(), 2);
+    EXPECT_TRUE(cooked_events[0].pressed);
+    EXPECT_FALSE(cooked_events[1].pressed);
+}
+#endif
+
+TEST_F(Debounce, RandomKeyStrokes) {
+    for (uint32_t seed = 1; seed <= 20; seed++) {
+        SCOPED_TRACE(seed);
+        events.clear();
+        strokes.clear();
+        cooked_events.clear();
+        rng.seed(seed);
+        add_random_keystrokes(50, MAX_BOUNCE_US, 4, MIN_EDGE_GAP_US);
+        run(250);
+        check_keystrokes();
+        if (HasFatalFailure()) {
+            return;
+        }
+    }
+}
+
+TEST_F(Debounce, DeadlinesAreNeverLate) {
+    add_random_keystrokes(50, MAX_BOUNCE_US, 4, MIN_EDGE_GAP_US);
+    run_to_deadlines(true);
+    std::vector<KeyEvent> every_ms_events = cooked_events;
+
+    cooked_events.clear();
+    scans = 0;
+    run_to_deadlines();
+    check_keystrokes();
+    ASSERT_EQ(cooked_events.size(), every_ms_events.size());
+    for (size_t i = 0; i < cooked_events.size(); i++) {
+        EXPECT_EQ(cooked_events[i].time_us, every_ms_events[i].time_us) << "event " << i;
+        EXPECT_EQ(cooked_events[i].row, every_ms_events[i].row) << "event " << i;
+        EXPECT_EQ(cooked_events[i].col, every_ms_events[i].col) << "event " << i;
+        EXPECT_EQ(cooked_events[i].pressed, every_ms_events[i].pressed) << "event " << i;
+    }
+    // besides the first scan and the events, debounce() only asks for scans where a key is due
+    EXPECT_LE(scans, 1 + events.size() + 2 * strokes.size() * SCANS_PER_EDGE);
+}
+
+/* Not a pass/fail test: prints the latency added by the algorithm and the time debounce() takes
+ * on the host, for typing with bouncy switches at a scan interval of 250us.
+ */
+TEST_F(Debounce, Benchmark) {
+    add_random_keystrokes(1000, MAX_BOUNCE_US, 4, MIN_EDGE_GAP_US);
+    run(250);
+    check_keystrokes();
+    double ns = ns_per_scan(250);
+    printf("%s: press latency avg %u max %u us, release latency avg %u max %u us, %u scans, %.1f ns/scan\n", XSTR(DEBOUNCE_NAME), press_latency.avg_us(), press_latency.max_us, release_latency.avg_us(), release_latency.max_us, scans, ns);
+}
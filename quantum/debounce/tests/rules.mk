@@ -0,0 +1,40 @@
+DEBOUNCE_COMMON_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCE=5 -DTIMER_SIMULATION
+
+DEBOUNCE_COMMON_SRC :=\
+	$(QUANTUM_PATH)/debounce/tests/debounce_test_common.cpp \
+	$(QUANTUM_PATH)/debounce/tests/debounce_tests.cpp \
+	$(TMK_PATH)/common/test/timer.c
+
+debounce_sym_defer_g_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_NAME=sym_defer_g -DDEBOUNCE_GLOBAL
+debounce_sym_defer_g_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_g.c
+
+debounce_sym_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_NAME=sym_defer_pk
+debounce_sym_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk.c
+
+debounce_sym_defer_vc_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_NAME=sym_defer_vc -DDEBOUNCE_TICKS
+debounce_sym_defer_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_vc.c
+
+debounce_sym_defer_pk_list_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_NAME=sym_defer_pk_list
+debounce_sym_defer_pk_list_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_list.c \
+	$(TMK_PATH)/common/util.c
+
+debounce_sym_eager_pk_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_NAME=sym_eager_pk -DDEBOUNCE_EAGER_PRESS -DDEBOUNCE_EAGER_RELEASE
+debounce_sym_eager_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk.c
+
+debounce_sym_eager_pk_list_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_NAME=sym_eager_pk_list -DDEBOUNCE_EAGER_PRESS -DDEBOUNCE_EAGER_RELEASE
+debounce_sym_eager_pk_list_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk_list.c \
+	$(TMK_PATH)/common/util.c
+
+debounce_sym_eager_pr_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_NAME=sym_eager_pr -DDEBOUNCE_EAGER_PRESS -DDEBOUNCE_EAGER_RELEASE
+debounce_sym_eager_pr_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pr.c
+
+debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_NAME=asym_eager_defer_pk -DDEBOUNCE_EAGER_PRESS
+debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c
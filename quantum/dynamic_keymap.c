@@ -97,6 +97,9 @@ void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address, (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+#ifdef RESOLVED_LAYER_CACHE
+    resolved_layer_cache_invalidate();
+#endif
 }
 
 void dynamic_keymap_reset(void) {
@@ -138,6 +141,9 @@ void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
         source++;
         target++;
     }
+#ifdef RESOLVED_LAYER_CACHE
+    resolved_layer_cache_invalidate();
+#endif
 }
 
 // This overrides the one in quantum/keymap_common.c
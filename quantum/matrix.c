@@ -16,12 +16,17 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "util.h"
 #include "matrix.h"
 #include "debounce.h"
 #include "quantum.h"
 
-#ifdef DIRECT_PINS
+#ifdef SHIFT_REGISTER_MATRIX_ENABLE
+#    include "shift_register_matrix.h"
+#elif defined(ANALOG_MATRIX_ENABLE)
+#    include "analog_matrix.h"
+#elif defined(DIRECT_PINS)
 static pin_t direct_pins[MATRIX_ROWS][MATRIX_COLS] = DIRECT_PINS;
 #elif (DIODE_DIRECTION == ROW2COL) || (DIODE_DIRECTION == COL2ROW)
 static const pin_t row_pins[MATRIX_ROWS] = MATRIX_ROW_PINS;
@@ -34,7 +39,15 @@ extern matrix_row_t matrix[MATRIX_ROWS];      // debounced values
 
 // matrix code
 
-#ifdef DIRECT_PINS
+#ifdef SHIFT_REGISTER_MATRIX_ENABLE
+
+static void init_pins(void) { shift_register_matrix_init(); }
+
+#elif defined(ANALOG_MATRIX_ENABLE)
+
+static void init_pins(void) { analog_matrix_init(MATRIX_ROWS); }
+
+#elif defined(DIRECT_PINS)
 
 static void init_pins(void) {
     for (int row = 0; row < MATRIX_ROWS; row++) {
@@ -82,13 +95,89 @@ static void unselect_rows(void) {
     }
 }
 
+#        ifdef MATRIX_PARALLEL_COL_READ
+/* Columns wired to consecutive pins of one port, in column order, are read together */
+typedef struct {
+    uint8_t     port;  // index into col_ports
+    uint8_t     pad;   // pin of the first column
+    uint8_t     col;   // first column
+    port_data_t mask;  // pins of the columns
+} col_run_t;
+
+static pin_t       col_ports[MATRIX_COLS];  // a pin of every port with columns on it
+static port_data_t col_port_masks[MATRIX_COLS];
+static uint8_t     col_port_count;
+static col_run_t col_runs[MATRIX_COLS];
+static uint8_t   col_run_count;
+
+static void init_col_runs(void) {
+    col_port_count = 0;
+    col_run_count  = 0;
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        pin_t   pin  = col_pins[col];
+        uint8_t port = 0;
+        while (port < col_port_count && getPinPort(col_ports[port]) != getPinPort(pin)) {
+            port++;
+        }
+        if (port == col_port_count) {
+            col_ports[col_port_count]      = pin;
+            col_port_masks[col_port_count] = 0;
+            col_port_count++;
+        }
+        col_port_masks[port] |= (port_data_t)1 << getPinPad(pin);
+
+        col_run_t *run = col_run_count ? &col_runs[col_run_count - 1] : NULL;
+        if (run && run->port == port && run->pad + (col - run->col) == getPinPad(pin)) {
+            run->mask |= (port_data_t)1 << getPinPad(pin);
+        } else {
+            col_runs[col_run_count++] = (col_run_t){.port = port, .pad = getPinPad(pin), .col = col, .mask = (port_data_t)1 << getPinPad(pin)};
+        }
+    }
+}
+#        endif
+
 static void init_pins(void) {
     unselect_rows();
     for (uint8_t x = 0; x < MATRIX_COLS; x++) {
         setPinInputHigh(col_pins[x]);
     }
+#        ifdef MATRIX_PARALLEL_COL_READ
+    init_col_runs();
+#        endif
 }
 
+#        ifdef MATRIX_PARALLEL_COL_READ
+static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
+    // Start with a clear matrix row
+    matrix_row_t current_row_value = 0;
+    port_data_t  port_values[MATRIX_COLS];
+
+    // Select row and wait for row selecton to stabilize
+    select_row(current_row);
+    matrix_io_delay();
+
+    // Read every port once (active low)
+    for (uint8_t port = 0; port < col_port_count; port++) {
+        port_values[port] = ~readPort(col_ports[port]);
+    }
+
+    // Unselect row
+    unselect_row(current_row);
+
+    // Move each run of pins to its columns
+    for (uint8_t i = 0; i < col_run_count; i++) {
+        const col_run_t *run = &col_runs[i];
+        current_row_value |= (matrix_row_t)((port_data_t)(port_values[run->port] & run->mask) >> run->pad) << run->col;
+    }
+
+    // If the row has changed, store the row and return the changed flag.
+    if (current_matrix[current_row] != current_row_value) {
+        current_matrix[current_row] = current_row_value;
+        return true;
+    }
+    return false;
+}
+#        else
 static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row) {
     // Start with a clear matrix row
     matrix_row_t current_row_value = 0;
@@ -116,6 +205,32 @@ static bool read_cols_on_row(matrix_row_t current_matrix[], uint8_t current_row)
     }
     return false;
 }
+#        endif
+
+#        ifdef MATRIX_FAST_IDLE_SCAN
+static bool any_key_down(void) {
+    bool down = false;
+
+    // Select all rows at once
+    for (uint8_t x = 0; x < MATRIX_ROWS; x++) {
+        select_row(x);
+    }
+    matrix_io_delay();
+
+#            ifdef MATRIX_PARALLEL_COL_READ
+    for (uint8_t port = 0; port < col_port_count && !down; port++) {
+        down = ~readPort(col_ports[port]) & col_port_masks[port];
+    }
+#            else
+    for (uint8_t x = 0; x < MATRIX_COLS && !down; x++) {
+        down = !readPin(col_pins[x]);
+    }
+#            endif
+
+    unselect_rows();
+    return down;
+}
+#        endif
 
 #    elif (DIODE_DIRECTION == ROW2COL)
 
@@ -174,6 +289,25 @@ static bool read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col)
     return matrix_changed;
 }
 
+#        ifdef MATRIX_FAST_IDLE_SCAN
+static bool any_key_down(void) {
+    bool down = false;
+
+    // Select all cols at once
+    for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+        select_col(x);
+    }
+    matrix_io_delay();
+
+    for (uint8_t x = 0; x < MATRIX_ROWS && !down; x++) {
+        down = !readPin(row_pins[x]);
+    }
+
+    unselect_cols();
+    return down;
+}
+#        endif
+
 #    else
 #        error DIODE_DIRECTION must be one of COL2ROW or ROW2COL!
 #    endif
@@ -181,6 +315,123 @@ static bool read_rows_on_col(matrix_row_t current_matrix[], uint8_t current_col)
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+#ifdef MATRIX_FAST_IDLE_SCAN
+#    ifdef DIRECT_PINS
+#        error MATRIX_FAST_IDLE_SCAN needs a row/column matrix, direct pins are already read in one pass
+#    endif
+#    ifdef SHIFT_REGISTER_MATRIX_ENABLE
+#        error MATRIX_FAST_IDLE_SCAN is not available with SHIFT_REGISTER_MATRIX_ENABLE
+#    endif
+#    ifdef ANALOG_MATRIX_ENABLE
+#        error MATRIX_FAST_IDLE_SCAN is not available with ANALOG_MATRIX_ENABLE
+#    endif
+/* no key was down or settling after the last scan */
+static volatile bool matrix_idle = false;
+#endif
+
+#ifdef MATRIX_SCAN_THREAD
+#    ifndef PROTOCOL_CHIBIOS
+#        error MATRIX_SCAN_THREAD is only available on ChibiOS
+#    endif
+#    ifndef MATRIX_SCAN_RATE
+#        define MATRIX_SCAN_RATE 2000
+#    endif
+#    ifndef MATRIX_SCAN_THREAD_PRIORITY
+#        define MATRIX_SCAN_THREAD_PRIORITY HIGHPRIO
+#    endif
+#    if MATRIX_SCAN_RATE > CH_CFG_ST_FREQUENCY
+#        error MATRIX_SCAN_RATE must not be above the system tick frequency CH_CFG_ST_FREQUENCY
+#    endif
+#endif
+
+/* Reads the whole matrix, returns true if it changed */
+static bool read_matrix(matrix_row_t current_matrix[]) {
+    bool changed = false;
+
+#ifdef MATRIX_FAST_IDLE_SCAN
+    // While nothing is down or settling, reading all keys at once tells if a full scan is needed
+    if (matrix_idle && !any_key_down()) {
+        return false;
+    }
+#endif
+
+#if defined(SHIFT_REGISTER_MATRIX_ENABLE)
+    changed = shift_register_matrix_read(current_matrix, MATRIX_ROWS);
+#elif defined(ANALOG_MATRIX_ENABLE)
+    changed = analog_matrix_read(current_matrix, MATRIX_ROWS);
+#elif defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
+    // Set row, read cols
+    for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
+        changed |= read_cols_on_row(current_matrix, current_row);
+    }
+#elif (DIODE_DIRECTION == ROW2COL)
+    // Set col, read rows
+    for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++) {
+        changed |= read_rows_on_col(current_matrix, current_col);
+    }
+#endif
+
+    return changed;
+}
+
+#ifdef MATRIX_SCAN_THREAD
+/* The scan thread publishes its n-th sample in samples[n & 1]. Readers copy the latest
+ * sample and retry if the thread has started writing over it in the meantime. */
+typedef struct {
+    matrix_row_t rows[MATRIX_ROWS];
+    uint32_t     changes;  // scans that changed the matrix so far
+} matrix_sample_t;
+
+static matrix_sample_t   samples[2];
+static volatile uint32_t sample_started   = 0;
+static volatile uint32_t sample_published = 0;
+
+static THD_WORKING_AREA(waMatrixScanThread, 512);
+static THD_FUNCTION(MatrixScanThread, arg) {
+    (void)arg;
+    chRegSetThreadName("matrix_scan");
+
+    matrix_row_t current_matrix[MATRIX_ROWS] = {0};
+    uint32_t     changes                     = 0;
+    systime_t    time                        = chVTGetSystemTimeX();
+
+    while (true) {
+        if (read_matrix(current_matrix)) {
+            changes++;
+        }
+
+        uint32_t         n      = sample_published + 1;
+        matrix_sample_t *sample = &samples[n & 1];
+        sample_started          = n;
+        __sync_synchronize();
+        memcpy(sample->rows, current_matrix, sizeof(current_matrix));
+        sample->changes = changes;
+        __sync_synchronize();
+        sample_published = n;
+
+        time = chThdSleepUntilWindowed(time, time + TIME_US2I(1000000 / MATRIX_SCAN_RATE));
+    }
+}
+
+/* Copies the latest sample of the scan thread, returns true if the matrix changed since the last call */
+static bool read_scan_thread(matrix_row_t current_matrix[]) {
+    static uint32_t seen_changes = 0;
+    uint32_t        n, changes;
+
+    do {
+        n = sample_published;
+        __sync_synchronize();
+        memcpy(current_matrix, samples[n & 1].rows, sizeof(samples[0].rows));
+        changes = samples[n & 1].changes;
+        __sync_synchronize();
+    } while (sample_started - n > 1);
+
+    bool changed = changes != seen_changes;
+    seen_changes = changes;
+    return changed;
+}
+#endif
+
 void matrix_init(void) {
     // initialize key pins
     init_pins();
@@ -194,25 +445,31 @@ void matrix_init(void) {
     debounce_init(MATRIX_ROWS);
 
     matrix_init_quantum();
+
+#ifdef MATRIX_SCAN_THREAD
+    chThdCreateStatic(waMatrixScanThread, sizeof(waMatrixScanThread), MATRIX_SCAN_THREAD_PRIORITY, MatrixScanThread, NULL);
+#endif
 }
 
 uint8_t matrix_scan(void) {
-    bool changed = false;
-
-#if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
-    // Set row, read cols
-    for (uint8_t current_row = 0; current_row < MATRIX_ROWS; current_row++) {
-        changed |= read_cols_on_row(raw_matrix, current_row);
-    }
-#elif (DIODE_DIRECTION == ROW2COL)
-    // Set col, read rows
-    for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++) {
-        changed |= read_rows_on_col(raw_matrix, current_col);
-    }
+#ifdef MATRIX_SCAN_THREAD
+    bool changed = read_scan_thread(raw_matrix);
+#else
+    bool changed = read_matrix(raw_matrix);
 #endif
 
     debounce(raw_matrix, matrix, MATRIX_ROWS, changed);
 
+#ifdef MATRIX_FAST_IDLE_SCAN
+    matrix_idle = true;
+    for (uint8_t i = 0; i < MATRIX_ROWS; i++) {
+        if (raw_matrix[i] || matrix[i]) {
+            matrix_idle = false;
+            break;
+        }
+    }
+#endif
+
     matrix_scan_quantum();
     return (uint8_t)changed;
 }
@@ -16,6 +16,7 @@
 
 #include "print.h"
 #include "process_combo.h"
+#include "latency_trace.h"
 
 #ifndef COMBO_VARIABLE_LEN
 __attribute__((weak)) combo_t key_combos[COMBO_COUNT] = {};
@@ -59,6 +60,7 @@ static inline void dump_key_buffer(bool emit) {
     if (emit) {
         for (uint8_t i = 0; i < buffer_size; i++) {
 #ifdef COMBO_ALLOW_ACTION_KEYS
+            LATENCY_TRACE_BEGIN(key_buffer[i].event);
             const action_t action = store_or_get_action(key_buffer[i].event.pressed, key_buffer[i].event.key);
             process_action(&(key_buffer[i]), action);
 #else
@@ -192,6 +194,9 @@ void matrix_scan_combo(void) {
         is_active = false;
         dump_key_buffer(true);
     }
+    if (b_combo_enable && is_active && timer) {
+        timer_deadline(timer + COMBO_TERM + 1);
+    }
 }
 
 void combo_enable(void) { b_combo_enable = true; }
@@ -176,6 +176,13 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
+/* Feature processors that only act on their own range of keycodes are
+ * skipped for every other keycode. Processors that have to see all events
+ * (key lock, dynamic macros, combos, tap dance, ...) are always called.
+ * Either way the order of the chain below is preserved.              */
+#define IS_KEYCODE_IN_RANGE(first, last) (keycode >= (first) && keycode <= (last))
+#define PROCESS_KEYCODE_RANGE(process, first, last) (!IS_KEYCODE_IN_RANGE(first, last) || process(keycode, record))
+
 /* Core keycode function, hands off handling to other functions,
     then processes internal quantum keycodes, and then processes
     ACTIONs.                                                      */
@@ -225,20 +232,20 @@ bool process_record_quantum(keyrecord_t *record) {
             process_rgb_matrix(keycode, record) &&
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(process_record_via, FN_MO13, MACRO15) &&
 #endif
             process_record_kb(keycode, record) &&
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(process_midi, MIDI_TONE_MIN, MI_BENDU) &&
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(process_audio, AU_ON, MUV_DE) &&
 #endif
 #ifdef BACKLIGHT_ENABLE
-            process_backlight(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(process_backlight, BL_ON, BL_BRTG) &&
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(process_steno, QK_STENO, QK_STENO_MAX) &&
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
             process_music(keycode, record) &&
@@ -246,8 +253,11 @@ bool process_record_quantum(keyrecord_t *record) {
 #ifdef TAP_DANCE_ENABLE
             process_tap_dance(keycode, record) &&
 #endif
-#if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
+#if defined(UCIS_ENABLE)
+            // UCIS input mode consumes all keys
             process_unicode_common(keycode, record) &&
+#elif defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE)
+            ((keycode < QK_UNICODE && !IS_KEYCODE_IN_RANGE(UNICODE_MODE_FORWARD, UNICODE_MODE_WINC)) || process_unicode_common(keycode, record)) &&
 #endif
 #ifdef LEADER_ENABLE
             process_leader(keycode, record) &&
@@ -268,13 +278,13 @@ bool process_record_quantum(keyrecord_t *record) {
             process_space_cadet(keycode, record) &&
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(process_magic, MAGIC_SWAP_CONTROL_CAPSLOCK, MAGIC_EE_HANDS_RIGHT) &&
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(process_grave_esc, GRAVE_ESC, GRAVE_ESC) &&
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(process_rgb, RGB_TOG, RGB_MODE_RGBTEST) &&
 #endif
 #ifdef JOYSTICK_ENABLE
             process_joystick(keycode, record) &&
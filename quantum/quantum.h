@@ -203,6 +203,12 @@ typedef uint8_t pin_t;
 
 #    define togglePin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin)&0xF))
 
+typedef uint8_t port_data_t;
+
+#    define getPinPort(pin) ((pin) >> PORT_SHIFTER)
+#    define getPinPad(pin) ((pin)&0xF)
+#    define readPort(pin) (PINx_ADDRESS(pin))
+
 #elif defined(PROTOCOL_CHIBIOS)
 typedef ioline_t pin_t;
 
@@ -218,6 +224,12 @@ typedef ioline_t pin_t;
 #    define readPin(pin) palReadLine(pin)
 
 #    define togglePin(pin) palToggleLine(pin)
+
+typedef ioportmask_t port_data_t;
+
+#    define getPinPort(pin) PAL_PORT(pin)
+#    define getPinPad(pin) PAL_PAD(pin)
+#    define readPort(pin) palReadPort(PAL_PORT(pin))
 #endif
 
 #define SEND_STRING(string) send_string_P(PSTR(string))
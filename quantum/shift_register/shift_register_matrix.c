@@ -0,0 +1,141 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "shift_register_matrix.h"
+#include "spi_master.h"
+
+#ifndef SHIFT_REG_CS_PIN
+#    error SHIFT_REG_CS_PIN must be defined, it selects the 74HC165 chain (CE)
+#endif
+
+#ifndef SHIFT_REG_LOAD_PIN
+#    error SHIFT_REG_LOAD_PIN must be defined, it loads the 74HC165 chain (SH/LD)
+#endif
+
+#ifndef SHIFT_REG_SPI_MODE
+#    define SHIFT_REG_SPI_MODE 0
+#endif
+
+#ifndef SHIFT_REG_SPI_DIVISOR
+#    define SHIFT_REG_SPI_DIVISOR 8
+#endif
+
+// bytes of 74HC165 input per row, the register closest to MISO holds columns 0-7
+#define COL_BYTES ((MATRIX_COLS + 7) / 8)
+#define COL_MASK ((matrix_row_t)((matrix_row_t)~(matrix_row_t)0 >> (sizeof(matrix_row_t) * 8 - MATRIX_COLS)))
+
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+static uint8_t rx_buffer[COL_BYTES];
+#else
+static uint8_t rx_buffer[MATRIX_ROWS * COL_BYTES];
+#endif
+
+/* Latches the key states into the 74HC165 chain and clocks them in, keys are active low.
+ * The buffer is cleared first as the AVR driver skips the bytes that read 0. */
+static bool receive_cols(uint16_t length) {
+    writePinLow(SHIFT_REG_LOAD_PIN);
+    writePinHigh(SHIFT_REG_LOAD_PIN);
+
+    memset(rx_buffer, 0, length);
+    if (!spi_start(SHIFT_REG_CS_PIN, false, SHIFT_REG_SPI_MODE, SHIFT_REG_SPI_DIVISOR)) {
+        return false;
+    }
+    spi_status_t status = spi_receive(rx_buffer, length);
+    spi_stop();
+    return status == SPI_STATUS_SUCCESS;
+}
+
+static bool store_row(matrix_row_t current_matrix[], uint8_t row, const uint8_t *data) {
+    matrix_row_t current_row_value = 0;
+    for (uint8_t i = 0; i < COL_BYTES; i++) {
+        current_row_value |= (matrix_row_t)(uint8_t)~data[i] << (i * 8);
+    }
+    current_row_value &= COL_MASK;
+
+    if (current_matrix[row] != current_row_value) {
+        current_matrix[row] = current_row_value;
+        return true;
+    }
+    return false;
+}
+
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+/* Shifts the row select pattern into the 74HC595 chain, active low. The first byte sent ends up
+ * in the register furthest from MOSI, so the rows 0-7 are sent last. The rising edge of the latch
+ * pin at spi_stop() moves it to the outputs. */
+static bool select_row(uint8_t row, uint8_t num_rows) {
+    uint8_t row_bytes = (num_rows + 7) / 8;
+    uint8_t tx_buffer[(MATRIX_ROWS + 7) / 8];
+
+    memset(tx_buffer, 0xFF, row_bytes);
+    if (row < num_rows) {
+        tx_buffer[row_bytes - 1 - row / 8] &= ~(1 << (row % 8));
+    }
+
+    if (!spi_start(SHIFT_REG_ROW_LATCH_PIN, false, SHIFT_REG_SPI_MODE, SHIFT_REG_SPI_DIVISOR)) {
+        return false;
+    }
+    spi_status_t status = spi_transmit(tx_buffer, row_bytes);
+    spi_stop();
+    return status == SPI_STATUS_SUCCESS;
+}
+#endif
+
+void shift_register_matrix_init(void) {
+    setPinOutput(SHIFT_REG_LOAD_PIN);
+    writePinHigh(SHIFT_REG_LOAD_PIN);
+    setPinOutput(SHIFT_REG_CS_PIN);
+    writePinHigh(SHIFT_REG_CS_PIN);
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+    setPinOutput(SHIFT_REG_ROW_LATCH_PIN);
+    writePinHigh(SHIFT_REG_ROW_LATCH_PIN);
+#endif
+
+    spi_init();
+
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+    // unselect all rows
+    select_row(MATRIX_ROWS, MATRIX_ROWS);
+#endif
+}
+
+bool shift_register_matrix_read(matrix_row_t current_matrix[], uint8_t num_rows) {
+    bool changed = false;
+
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+    for (uint8_t row = 0; row < num_rows; row++) {
+        // Select row and wait for row selection to stabilize
+        if (!select_row(row, num_rows)) {
+            break;
+        }
+        matrix_io_delay();
+
+        if (receive_cols(COL_BYTES)) {
+            changed |= store_row(current_matrix, row, rx_buffer);
+        }
+    }
+#else
+    // The whole matrix in one transfer, which ChibiOS does by DMA
+    if (receive_cols(num_rows * COL_BYTES)) {
+        for (uint8_t row = 0; row < num_rows; row++) {
+            changed |= store_row(current_matrix, row, &rx_buffer[row * COL_BYTES]);
+        }
+    }
+#endif
+
+    return changed;
+}
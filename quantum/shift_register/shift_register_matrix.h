@@ -0,0 +1,32 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix.h"
+
+/* Scans the matrix through SPI shift registers: 74HC165 parallel in, serial out registers read
+ * the columns, and 74HC595 serial in, parallel out registers drive the rows when
+ * SHIFT_REG_ROW_LATCH_PIN is defined. Without row registers every key has its own 74HC165 input
+ * and the whole matrix is read in one transfer.
+ */
+
+void shift_register_matrix_init(void);
+
+/* Reads the first num_rows rows, returns true if any of them changed */
+bool shift_register_matrix_read(matrix_row_t current_matrix[], uint8_t num_rows);
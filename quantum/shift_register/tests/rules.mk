@@ -0,0 +1,16 @@
+SHIFT_REGISTER_COMMON_DEFS := -DMATRIX_ROWS=5 -DMATRIX_COLS=12 -DSHIFT_REG_CS_PIN=1 -DSHIFT_REG_LOAD_PIN=2
+
+SHIFT_REGISTER_COMMON_SRC :=\
+	$(QUANTUM_PATH)/shift_register/tests/shift_register_matrix_tests.cpp \
+	$(QUANTUM_PATH)/shift_register/tests/shift_register_mock.cpp \
+	$(QUANTUM_PATH)/shift_register/shift_register_matrix.c
+
+SHIFT_REGISTER_COMMON_INC := $(QUANTUM_PATH)/shift_register/tests $(QUANTUM_PATH)/shift_register
+
+shift_register_matrix_rows_DEFS := $(SHIFT_REGISTER_COMMON_DEFS) -DSHIFT_REG_ROW_LATCH_PIN=3
+shift_register_matrix_rows_SRC := $(SHIFT_REGISTER_COMMON_SRC)
+shift_register_matrix_rows_INC := $(SHIFT_REGISTER_COMMON_INC)
+
+shift_register_matrix_snapshot_DEFS := $(SHIFT_REGISTER_COMMON_DEFS)
+shift_register_matrix_snapshot_SRC := $(SHIFT_REGISTER_COMMON_SRC)
+shift_register_matrix_snapshot_INC := $(SHIFT_REGISTER_COMMON_INC)
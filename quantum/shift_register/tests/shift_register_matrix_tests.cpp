@@ -0,0 +1,112 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Built once with rows driven by 74HC595 registers and once with every key on its own 74HC165
+ * input, see rules.mk. */
+
+#include "gtest/gtest.h"
+#include "shift_register_mock.h"
+
+extern "C" {
+#include "shift_register_matrix.h"
+}
+
+#define COL_BYTES ((MATRIX_COLS + 7) / 8)
+
+class ShiftRegisterMatrix : public ::testing::Test {
+   protected:
+    ShiftRegisterMatrix() : sr(MATRIX_ROWS, COL_BYTES) {}
+
+    void SetUp() override {
+        ShiftRegisterMock::instance = &sr;
+        shift_register_matrix_init();
+        sr.transmits = 0;
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(sr.errors, 0);
+        ShiftRegisterMock::instance = nullptr;
+    }
+
+    bool read(uint8_t num_rows = MATRIX_ROWS) { return shift_register_matrix_read(current_matrix, num_rows); }
+
+    ShiftRegisterMock sr;
+    matrix_row_t      current_matrix[MATRIX_ROWS] = {0};
+};
+
+TEST_F(ShiftRegisterMatrix, NoKeys) {
+    EXPECT_FALSE(read());
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        EXPECT_EQ(current_matrix[row], 0);
+    }
+}
+
+TEST_F(ShiftRegisterMatrix, KeysAreReportedInPlace) {
+    sr.press(0, 0);
+    sr.press(0, 7);
+    sr.press(1, 8);
+    sr.press(2, MATRIX_COLS - 1);
+    sr.press(MATRIX_ROWS - 1, 3);
+    EXPECT_TRUE(read());
+    EXPECT_EQ(current_matrix[0], 0b10000001);
+    EXPECT_EQ(current_matrix[1], 1 << 8);
+    EXPECT_EQ(current_matrix[2], 1 << (MATRIX_COLS - 1));
+    EXPECT_EQ(current_matrix[3], 0);
+    EXPECT_EQ(current_matrix[MATRIX_ROWS - 1], 1 << 3);
+    EXPECT_FALSE(read());
+
+    sr.release(1, 8);
+    EXPECT_TRUE(read());
+    EXPECT_EQ(current_matrix[1], 0);
+}
+
+TEST_F(ShiftRegisterMatrix, AllKeysOfARow) {
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        sr.press(3, col);
+    }
+    EXPECT_TRUE(read());
+    EXPECT_EQ(current_matrix[2], 0);
+    EXPECT_EQ(current_matrix[3], (1 << MATRIX_COLS) - 1);
+    EXPECT_EQ(current_matrix[4], 0);
+}
+
+TEST_F(ShiftRegisterMatrix, UnusedInputsAreIgnored) {
+    sr.unused_inputs_low = true;
+    sr.press(1, 2);
+    EXPECT_TRUE(read());
+    EXPECT_EQ(current_matrix[0], 0);
+    EXPECT_EQ(current_matrix[1], 1 << 2);
+}
+
+TEST_F(ShiftRegisterMatrix, ReadsOnlyTheRowsOfThisHalf) {
+    sr.press(0, 1);
+    sr.press(MATRIX_ROWS - 1, 1);
+    current_matrix[MATRIX_ROWS - 1] = 0x55;
+    EXPECT_TRUE(read(2));
+    EXPECT_EQ(current_matrix[0], 1 << 1);
+    EXPECT_EQ(current_matrix[MATRIX_ROWS - 1], 0x55);
+}
+
+TEST_F(ShiftRegisterMatrix, TransfersPerScan) {
+    read();
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+    EXPECT_EQ(sr.transmits, MATRIX_ROWS);
+    EXPECT_EQ(sr.receives, MATRIX_ROWS);
+#else
+    EXPECT_EQ(sr.transmits, 0);
+    EXPECT_EQ(sr.receives, 1);
+#endif
+}
@@ -0,0 +1,156 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shift_register_mock.h"
+#include "spi_master.h"
+
+ShiftRegisterMock *ShiftRegisterMock::instance = nullptr;
+
+ShiftRegisterMock::ShiftRegisterMock(uint8_t rows, uint8_t col_bytes) : rows(rows), col_bytes(col_bytes), keys(rows, std::vector<bool>(col_bytes * 8, false)), pin_output(256, false), pin_level(256, false) {
+    row_shift.assign((rows + 7) / 8, 0xFF);
+    row_latch.assign((rows + 7) / 8, 0xFF);
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+    col_shift.assign(col_bytes, 0xFF);
+#else
+    col_shift.assign(rows * col_bytes, 0xFF);
+#endif
+}
+
+bool ShiftRegisterMock::input_level(uint16_t byte, uint8_t bit) const {
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+    uint8_t col = byte * 8 + bit;
+    if (col >= MATRIX_COLS) {
+        return !unused_inputs_low;
+    }
+    for (uint8_t row = 0; row < rows; row++) {
+        bool driven_low = !(row_latch[row / 8] & (1 << (row % 8)));
+        if (driven_low && keys[row][col]) {
+            return false;
+        }
+    }
+    return true;
+#else
+    uint8_t row = byte / col_bytes;
+    uint8_t col = (byte % col_bytes) * 8 + bit;
+    if (col >= MATRIX_COLS) {
+        return !unused_inputs_low;
+    }
+    return !keys[row][col];
+#endif
+}
+
+void ShiftRegisterMock::set_pin_output(uint8_t pin) { pin_output[pin] = true; }
+
+void ShiftRegisterMock::write_pin(uint8_t pin, bool level) {
+    if (!pin_output[pin]) {
+        errors++;
+    }
+#ifdef SHIFT_REG_ROW_LATCH_PIN
+    if (pin == SHIFT_REG_ROW_LATCH_PIN && !pin_level[pin] && level) {
+        row_latch = row_shift;
+    }
+#endif
+    pin_level[pin] = level;
+
+    if (pin == SHIFT_REG_LOAD_PIN && !level) {
+        // parallel load, input A is the last bit shifted out
+        for (uint16_t byte = 0; byte < col_shift.size(); byte++) {
+            col_shift[byte] = 0;
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                col_shift[byte] |= input_level(byte, bit) << bit;
+            }
+        }
+    }
+}
+
+bool ShiftRegisterMock::start(uint8_t pin, bool lsb_first) {
+    if (selected || lsb_first) {
+        errors++;
+        return false;
+    }
+    selected = pin;
+    write_pin(pin, false);
+    return true;
+}
+
+void ShiftRegisterMock::transmit(const uint8_t *data, uint16_t length) {
+    if (!selected) {
+        errors++;
+        return;
+    }
+    transmits++;
+    for (uint16_t i = 0; i < length; i++) {
+        row_shift.insert(row_shift.begin(), data[i]);
+        row_shift.pop_back();
+        if (selected == SHIFT_REG_CS_PIN) {
+            col_shift.erase(col_shift.begin());
+            col_shift.push_back(0xFF);
+        }
+    }
+}
+
+void ShiftRegisterMock::receive(uint8_t *data, uint16_t length) {
+    if (!selected) {
+        errors++;
+        return;
+    }
+    receives++;
+    for (uint16_t i = 0; i < length; i++) {
+        // the 74HC165 chain only shifts while selected, MISO is pulled up otherwise
+        if (selected == SHIFT_REG_CS_PIN) {
+            data[i] = col_shift[0];
+            col_shift.erase(col_shift.begin());
+            col_shift.push_back(0xFF);
+        } else {
+            data[i] = 0xFF;
+        }
+        row_shift.insert(row_shift.begin(), 0xFF);
+        row_shift.pop_back();
+    }
+}
+
+void ShiftRegisterMock::stop(void) {
+    if (!selected) {
+        errors++;
+        return;
+    }
+    write_pin(selected, true);
+    selected = 0;
+}
+
+extern "C" {
+void mock_set_pin_output(pin_t pin) { ShiftRegisterMock::instance->set_pin_output(pin); }
+
+void mock_write_pin(pin_t pin, bool level) { ShiftRegisterMock::instance->write_pin(pin, level); }
+
+void spi_init(void) {}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) { return ShiftRegisterMock::instance->start(slavePin, lsbFirst); }
+
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    ShiftRegisterMock::instance->transmit(data, length);
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    ShiftRegisterMock::instance->receive(data, length);
+    return SPI_STATUS_SUCCESS;
+}
+
+void spi_stop(void) { ShiftRegisterMock::instance->stop(); }
+
+void matrix_io_delay(void) {}
+}
@@ -0,0 +1,66 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+extern "C" {
+#include "matrix.h"
+}
+
+/* Simulates a 74HC595 chain driving the rows, when SHIFT_REG_ROW_LATCH_PIN is defined, and a
+ * 74HC165 chain reading the columns, on one SPI bus. A column input reads low when a pressed key
+ * connects it to a row that is driven low.
+ */
+class ShiftRegisterMock {
+   public:
+    ShiftRegisterMock(uint8_t rows, uint8_t col_bytes);
+
+    void press(uint8_t row, uint8_t col) { keys[row][col] = true; }
+    void release(uint8_t row, uint8_t col) { keys[row][col] = false; }
+
+    // register inputs without a key, pulled low to check they are ignored
+    bool unused_inputs_low = false;
+
+    uint32_t receives  = 0;
+    uint32_t transmits = 0;
+    uint32_t errors    = 0;
+
+    // how the driver drives the pins and the bus
+    void set_pin_output(uint8_t pin);
+    void write_pin(uint8_t pin, bool level);
+    bool start(uint8_t pin, bool lsb_first);
+    void transmit(const uint8_t *data, uint16_t length);
+    void receive(uint8_t *data, uint16_t length);
+    void stop(void);
+
+    static ShiftRegisterMock *instance;
+
+   private:
+    bool    input_level(uint16_t byte, uint8_t bit) const;
+    uint8_t rows;
+    uint8_t col_bytes;
+
+    std::vector<std::vector<bool>> keys;
+    std::vector<bool>              pin_output;
+    std::vector<bool>              pin_level;
+    uint8_t                        selected = 0;
+    std::vector<uint8_t>           row_shift;  // [0] is the 74HC595 closest to MOSI
+    std::vector<uint8_t>           row_latch;
+    std::vector<uint8_t>           col_shift;  // [0] is the 74HC165 closest to MISO
+};
@@ -0,0 +1,3 @@
+TEST_LIST +=\
+	shift_register_matrix_rows\
+	shift_register_matrix_snapshot
\ No newline at end of file
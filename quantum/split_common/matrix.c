@@ -28,7 +28,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define ROWS_PER_HAND (MATRIX_ROWS / 2)
 
-#ifdef DIRECT_PINS
+#ifdef SHIFT_REGISTER_MATRIX_ENABLE
+#    include "shift_register_matrix.h"
+#elif defined(ANALOG_MATRIX_ENABLE)
+#    include "analog_matrix.h"
+#elif defined(DIRECT_PINS)
 static pin_t direct_pins[MATRIX_ROWS][MATRIX_COLS] = DIRECT_PINS;
 #elif (DIODE_DIRECTION == ROW2COL) || (DIODE_DIRECTION == COL2ROW)
 static pin_t row_pins[MATRIX_ROWS] = MATRIX_ROW_PINS;
@@ -47,7 +51,15 @@ __attribute__((weak)) void matrix_slave_scan_user(void) {}
 
 // matrix code
 
-#ifdef DIRECT_PINS
+#ifdef SHIFT_REGISTER_MATRIX_ENABLE
+
+static void init_pins(void) { shift_register_matrix_init(); }
+
+#elif defined(ANALOG_MATRIX_ENABLE)
+
+static void init_pins(void) { analog_matrix_init(ROWS_PER_HAND); }
+
+#elif defined(DIRECT_PINS)
 
 static void init_pins(void) {
     for (int row = 0; row < MATRIX_ROWS; row++) {
@@ -268,7 +280,11 @@ void matrix_post_scan(void) {
 uint8_t matrix_scan(void) {
     bool changed = false;
 
-#if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
+#if defined(SHIFT_REGISTER_MATRIX_ENABLE)
+    changed = shift_register_matrix_read(raw_matrix, ROWS_PER_HAND);
+#elif defined(ANALOG_MATRIX_ENABLE)
+    changed = analog_matrix_read(raw_matrix, ROWS_PER_HAND);
+#elif defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
     // Set row, read cols
     for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
         changed |= read_cols_on_row(raw_matrix, current_row);
@@ -0,0 +1,64 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Packing of the rows of one hand (ROWS_PER_HAND, defined by the includer) for the split
+ * transport. The rows are sent with MATRIX_COLS bits each, one after the other, lowest bit first.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "matrix.h"
+
+#define PACKED_MATRIX_SIZE ((ROWS_PER_HAND * MATRIX_COLS + 7) / 8)
+#define COL_MASK ((matrix_row_t)((matrix_row_t)~(matrix_row_t)0 >> (sizeof(matrix_row_t) * 8 - MATRIX_COLS)))
+
+// holds a row and the bits of the byte before it
+#if MATRIX_COLS > 24
+typedef uint64_t packed_window_t;
+#else
+typedef uint32_t packed_window_t;
+#endif
+
+static inline void pack_matrix(uint8_t packed[], const matrix_row_t matrix[]) {
+    packed_window_t window = 0;
+    uint8_t         bits   = 0;
+    uint8_t         i      = 0;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        window |= (packed_window_t)(matrix[row] & COL_MASK) << bits;
+        for (bits += MATRIX_COLS; bits >= 8; bits -= 8) {
+            packed[i++] = window;
+            window >>= 8;
+        }
+    }
+    if (bits) {
+        packed[i] = window;
+    }
+}
+
+static inline void unpack_matrix(matrix_row_t matrix[], const uint8_t packed[]) {
+    packed_window_t window = 0;
+    uint8_t         bits   = 0;
+    uint8_t         i      = 0;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (; bits < MATRIX_COLS; bits += 8) {
+            window |= (packed_window_t)packed[i++] << bits;
+        }
+        matrix[row] = window & COL_MASK;
+        window >>= MATRIX_COLS;
+        bits -= MATRIX_COLS;
+    }
+}
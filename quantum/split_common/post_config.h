@@ -8,12 +8,18 @@
 #        define F_SCL 100000UL  // SCL frequency
 #    endif
 
+// Room for the split sync packets next to the matrix
+#    ifndef I2C_SLAVE_REG_COUNT
+#        define I2C_SLAVE_REG_COUNT 64
+#    endif
+
 #else  // use serial
 // When using serial, the user must define RGBLIGHT_SPLIT explicitly
 //  in config.h as needed.
 //      see quantum/rgblight_post_config.h
-#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
-// When using serial and RGBLIGHT_SPLIT need separate transaction
+// RGBLIGHT_SPLIT, SPLIT_TRANSPORT_ON_CHANGE and the split sync packets
+// need separate transactions
+#    ifndef SERIAL_USE_MULTI_TRANSACTION
 #        define SERIAL_USE_MULTI_TRANSACTION
 #    endif
 #endif
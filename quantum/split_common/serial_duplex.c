@@ -0,0 +1,158 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "serial_duplex.h"
+#include "timer.h"
+#ifdef SPLIT_TRANSPORT_STATS
+#    include "split_stats.h"
+#endif
+
+#if SERIAL_DUPLEX_MAX_PAYLOAD > 250
+#    error SERIAL_DUPLEX_MAX_PAYLOAD must be at most 250
+#endif
+
+#define SERIAL_DUPLEX_FRAME_SIZE (SERIAL_DUPLEX_OVERHEAD + SERIAL_DUPLEX_MAX_PAYLOAD)
+
+/* The initiator sends each copy of a request within a timeout, plus its transfer, of the previous
+ * copy. A matching id that arrives later is a new request after an outage or a restart of the
+ * initiator: the 16 failed transactions that bring the sequence back around take far longer. */
+#define SERIAL_DUPLEX_REPEAT_WINDOW (2 * SERIAL_DUPLEX_TIMEOUT)
+
+static uint8_t  initiator_sequence;
+static uint8_t  target_last_id = 0xFF;
+static uint32_t target_last_time;
+
+uint16_t serial_duplex_crc16(const uint8_t *data, uint8_t size) {
+    uint16_t crc = 0xFFFF;
+    while (size--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static uint8_t encode(uint8_t *frame, uint8_t id, const uint8_t *payload, uint8_t length) {
+    frame[0] = SERIAL_DUPLEX_SYNC;
+    frame[1] = id;
+    frame[2] = length;
+    if (length) {
+        memcpy(&frame[SERIAL_DUPLEX_HEADER_SIZE], payload, length);
+    }
+    uint16_t crc                                   = serial_duplex_crc16(&frame[1], length + 2);
+    frame[SERIAL_DUPLEX_HEADER_SIZE + length]     = crc & 0xFF;
+    frame[SERIAL_DUPLEX_HEADER_SIZE + length + 1] = crc >> 8;
+    return length + SERIAL_DUPLEX_OVERHEAD;
+}
+
+// Whether the frame is complete and undamaged, with the id and a payload of length bytes
+static bool check(const uint8_t *frame, uint8_t id, uint8_t length) {
+    if (frame[0] != SERIAL_DUPLEX_SYNC || frame[1] != id || frame[2] != length) {
+        return false;
+    }
+    uint16_t crc = serial_duplex_crc16(&frame[1], length + 2);
+    return frame[SERIAL_DUPLEX_HEADER_SIZE + length] == (crc & 0xFF) && frame[SERIAL_DUPLEX_HEADER_SIZE + length + 1] == crc >> 8;
+}
+
+int serial_duplex_transaction(SSTD_t *trans, uint8_t tid) {
+    uint8_t request[SERIAL_DUPLEX_FRAME_SIZE];
+    uint8_t response[SERIAL_DUPLEX_FRAME_SIZE];
+    uint8_t length = trans->target2initiator_buffer_size;
+
+    if (tid > 0x0F || trans->initiator2target_buffer_size > SERIAL_DUPLEX_MAX_PAYLOAD || length > SERIAL_DUPLEX_MAX_PAYLOAD) {
+        return TRANSACTION_TYPE_ERROR;
+    }
+
+    initiator_sequence = (initiator_sequence + 1) & 0x0F;
+    uint8_t id         = tid << 4 | initiator_sequence;
+    uint8_t size       = encode(request, id, trans->initiator2target_buffer, trans->initiator2target_buffer_size);
+
+    int result = TRANSACTION_NO_RESPONSE;
+    for (uint8_t attempt = 0; attempt <= SERIAL_DUPLEX_RETRIES; attempt++) {
+#ifdef SPLIT_TRANSPORT_STATS
+        if (attempt) {
+            split_stats_retry();
+        }
+#endif
+        // the rest of a late or damaged response
+        serial_duplex_port_flush();
+        if (!serial_duplex_port_exchange(request, size, response, length + SERIAL_DUPLEX_OVERHEAD, SERIAL_DUPLEX_TIMEOUT)) {
+            result = TRANSACTION_NO_RESPONSE;
+            continue;
+        }
+        if (!check(response, id, length)) {
+            result = TRANSACTION_DATA_ERROR;
+            continue;
+        }
+        if (length) {
+            memcpy(trans->target2initiator_buffer, &response[SERIAL_DUPLEX_HEADER_SIZE], length);
+        }
+        result = TRANSACTION_END;
+        break;
+    }
+
+    if (trans->status) {
+        *trans->status = result;
+    }
+    return result;
+}
+
+void serial_duplex_target_task(SSTD_t *table, uint8_t table_size) {
+    uint8_t frame[SERIAL_DUPLEX_FRAME_SIZE];
+
+    // anything else is the rest of a damaged frame, or noise
+    do {
+        if (!serial_duplex_port_receive(frame, 1, 0)) {
+            return;
+        }
+    } while (frame[0] != SERIAL_DUPLEX_SYNC);
+
+    if (!serial_duplex_port_receive(&frame[1], 2, SERIAL_DUPLEX_TIMEOUT)) {
+        return;
+    }
+    uint8_t id     = frame[1];
+    uint8_t tid    = id >> 4;
+    uint8_t length = frame[2];
+    if (tid >= table_size || length != table[tid].initiator2target_buffer_size || length > SERIAL_DUPLEX_MAX_PAYLOAD) {
+        return;
+    }
+    if (!serial_duplex_port_receive(&frame[SERIAL_DUPLEX_HEADER_SIZE], length + SERIAL_DUPLEX_CRC_SIZE, SERIAL_DUPLEX_TIMEOUT) || !check(frame, id, length)) {
+        return;
+    }
+
+    SSTD_t *trans = &table[tid];
+    // a repeated request, the initiator has missed the response
+    bool repeated = id == target_last_id && timer_elapsed32(target_last_time) <= SERIAL_DUPLEX_REPEAT_WINDOW;
+    if (!repeated) {
+        if (length) {
+            memcpy(trans->initiator2target_buffer, &frame[SERIAL_DUPLEX_HEADER_SIZE], length);
+        }
+        target_last_id = id;
+    }
+    target_last_time = timer_read32();
+
+    if (trans->target2initiator_buffer_size > SERIAL_DUPLEX_MAX_PAYLOAD) {
+        return;
+    }
+    uint8_t size = encode(frame, id, trans->target2initiator_buffer, trans->target2initiator_buffer_size);
+    serial_duplex_port_send(frame, size);
+
+    if (!repeated && trans->status) {
+        *trans->status = TRANSACTION_ACCEPTED;
+    }
+}
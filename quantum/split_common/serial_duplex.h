@@ -0,0 +1,75 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Framed transactions of the split serial link, over a full duplex port such as a UART with DMA.
+ *
+ * A transaction is a request frame from the initiator and a response frame from the target:
+ *
+ *   0xA5 <tid:4 sequence:4> <length> <payload> <crc16 low> <crc16 high>
+ *
+ * The request carries the initiator to target buffer of the transaction and the response the
+ * target to initiator buffer. The CRC (CCITT, 0xFFFF) covers everything after the sync byte. The
+ * initiator sends the request again when the response is missing or damaged, and the target
+ * answers a repeated request without applying it a second time. A request is only taken as a
+ * repeat when the previous copy arrived less than two timeouts before.
+ *
+ * The port, see below, moves the bytes. It is implemented by the driver, and by a loopback in the
+ * unit tests.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "serial.h"
+
+#define SERIAL_DUPLEX_SYNC 0xA5
+#define SERIAL_DUPLEX_HEADER_SIZE 3
+#define SERIAL_DUPLEX_CRC_SIZE 2
+#define SERIAL_DUPLEX_OVERHEAD (SERIAL_DUPLEX_HEADER_SIZE + SERIAL_DUPLEX_CRC_SIZE)
+
+// the largest transaction buffer
+#ifndef SERIAL_DUPLEX_MAX_PAYLOAD
+#    define SERIAL_DUPLEX_MAX_PAYLOAD 64
+#endif
+
+// how often a request is sent again before the transaction fails
+#ifndef SERIAL_DUPLEX_RETRIES
+#    define SERIAL_DUPLEX_RETRIES 3
+#endif
+
+// milliseconds to wait for the response, and for the rest of a request once it has started
+#ifndef SERIAL_DUPLEX_TIMEOUT
+#    define SERIAL_DUPLEX_TIMEOUT 5
+#endif
+
+uint16_t serial_duplex_crc16(const uint8_t *data, uint8_t size);
+
+// Runs a transaction on the initiator, returns TRANSACTION_END or the error
+int serial_duplex_transaction(SSTD_t *trans, uint8_t tid);
+
+// Waits for a request on the target and answers it
+void serial_duplex_target_task(SSTD_t *table, uint8_t table_size);
+
+/* The port */
+
+// Starts receiving rx_size bytes, sends tx_size bytes and waits up to timeout ms for the reception.
+bool serial_duplex_port_exchange(const uint8_t *tx, uint8_t tx_size, uint8_t *rx, uint8_t rx_size, uint16_t timeout);
+// Waits up to timeout ms for size bytes, or forever when timeout is 0.
+bool serial_duplex_port_receive(uint8_t *rx, uint8_t size, uint16_t timeout);
+bool serial_duplex_port_send(const uint8_t *tx, uint8_t size);
+// Drops the bytes that have been received but not read.
+void serial_duplex_port_flush(void);
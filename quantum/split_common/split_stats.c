@@ -0,0 +1,214 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "split_stats.h"
+#include "timer.h"
+#include "print.h"
+#ifdef OLED_DRIVER_ENABLE
+#    include "oled_driver.h"
+#endif
+
+#ifdef SPLIT_TRANSPORT_STATS
+
+static split_stats_t stats[SPLIT_STATS_TRANSACTIONS];
+static uint8_t       running = SPLIT_STATS_TRANSACTIONS;
+
+// Print these variables if NO_PRINT or USER_PRINT are not defined.
+#    if !defined(NO_PRINT) && !defined(USER_PRINT)
+static const char *const transaction_names[SPLIT_STATS_TRANSACTIONS] = {
+    [SPLIT_STATS_SCAN] = "scan", [SPLIT_STATS_SEQUENCE] = "sequence", [SPLIT_STATS_MATRIX] = "matrix", [SPLIT_STATS_ENCODERS] = "encoders", [SPLIT_STATS_RGBLIGHT] = "rgblight", [SPLIT_STATS_SYNC_TO_SLAVE] = "sync to slave", [SPLIT_STATS_SYNC_TO_MASTER] = "sync to master",
+};
+#    endif
+
+uint32_t split_stats_begin(uint8_t transaction) {
+    running = transaction;
+    return timer_read_us();
+}
+
+/** \brief Record one attempt of a transaction
+ */
+void split_stats_end(uint8_t transaction, uint32_t start_us, split_stats_result_t result) {
+    uint32_t elapsed_us = timer_read_us() - start_us;
+    running             = SPLIT_STATS_TRANSACTIONS;
+    if (transaction >= SPLIT_STATS_TRANSACTIONS) {
+        return;
+    }
+
+    split_stats_t *s  = &stats[transaction];
+    uint16_t       us = elapsed_us > UINT16_MAX ? UINT16_MAX : elapsed_us;
+    if (!s->attempts || us < s->min_us) {
+        s->min_us = us;
+    }
+    if (us > s->max_us) {
+        s->max_us = us;
+    }
+    s->attempts++;
+    s->total_us += elapsed_us;
+    if (result != SPLIT_STATS_OK) {
+        s->failures++;
+    }
+    if (result == SPLIT_STATS_TIMEOUT) {
+        s->timeouts++;
+    }
+
+    uint8_t bucket = 0;
+    for (elapsed_us >>= 3; elapsed_us > 1 && bucket < SPLIT_STATS_BUCKETS - 1; elapsed_us >>= 1) {
+        bucket++;
+    }
+    if (s->histogram[bucket] < UINT16_MAX) {
+        s->histogram[bucket]++;
+    }
+}
+
+void split_stats_retry(void) {
+    if (running < SPLIT_STATS_TRANSACTIONS) {
+        stats[running].retries++;
+    }
+}
+
+const split_stats_t *split_stats_get(uint8_t transaction) { return transaction < SPLIT_STATS_TRANSACTIONS ? &stats[transaction] : 0; }
+
+uint16_t split_stats_quality(void) {
+    uint32_t attempts = 0;
+    uint32_t failures = 0;
+    for (uint8_t i = SPLIT_STATS_SCAN + 1; i < SPLIT_STATS_TRANSACTIONS; i++) {
+        attempts += stats[i].attempts;
+        failures += stats[i].failures;
+    }
+    if (!attempts) {
+        return 1000;
+    }
+    // keep (attempts - failures) * 1000 within 32 bits
+    while (attempts > UINT32_MAX / 1000) {
+        attempts >>= 1;
+        failures >>= 1;
+    }
+    return (attempts - failures) * 1000 / attempts;
+}
+
+void split_stats_clear(void) {
+    memset(stats, 0, sizeof(stats));
+    running = SPLIT_STATS_TRANSACTIONS;
+}
+
+/** \brief Print the statistics to the console
+ *
+ * One line per transaction that has run, with its counters, min/avg/max in microseconds and the
+ * histogram buckets.
+ */
+void split_stats_print(void) {
+#    if !defined(NO_PRINT) && !defined(USER_PRINT)
+    uint16_t quality = split_stats_quality();
+    xprintf("split link: %u.%u%% ok\n", quality / 10, quality % 10);
+    for (uint8_t i = 0; i < SPLIT_STATS_TRANSACTIONS; i++) {
+        const split_stats_t *s = &stats[i];
+        if (!s->attempts) {
+            continue;
+        }
+        xprintf("%s: n %lu fail %lu timeout %lu retry %lu min %u avg %lu max %u us |", transaction_names[i], s->attempts, s->failures, s->timeouts, s->retries, s->min_us, s->total_us / s->attempts, s->max_us);
+        for (uint8_t b = 0; b < SPLIT_STATS_BUCKETS; b++) {
+            xprintf(" %u", s->histogram[b]);
+        }
+        xprintf("\n");
+    }
+#    endif
+}
+
+static void put_u16(uint8_t *data, uint16_t value) {
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+}
+
+static void put_u32(uint8_t *data, uint32_t value) {
+    put_u16(&data[0], value >> 16);
+    put_u16(&data[2], value & 0xFFFF);
+}
+
+/** \brief Answer a raw HID split link request
+ *
+ * Request: SPLIT_STATS_RAW_HID_ID, index. Index 0xFF returns the number of transactions and the
+ * quality. Lower indexes return attempts, failures, timeouts, retries, min, avg and max of that
+ * transaction, and with bit 7 set its histogram instead. All values are big endian, like the
+ * rest of the raw HID protocol. An unknown index is returned as 0xFE.
+ */
+bool split_stats_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (data[0] != SPLIT_STATS_RAW_HID_ID || length < 2 + 2 * SPLIT_STATS_BUCKETS) {
+        return false;
+    }
+
+    uint8_t index = data[1];
+    memset(&data[2], 0, length - 2);
+
+    const split_stats_t *s = split_stats_get(index & 0x7F);
+    if (index == 0xFF) {
+        data[2] = SPLIT_STATS_TRANSACTIONS;
+        put_u16(&data[3], split_stats_quality());
+    } else if (!s) {
+        data[1] = 0xFE;
+    } else if (index & 0x80) {
+        for (uint8_t b = 0; b < SPLIT_STATS_BUCKETS; b++) {
+            put_u16(&data[2 + 2 * b], s->histogram[b]);
+        }
+    } else {
+        put_u32(&data[2], s->attempts);
+        put_u32(&data[6], s->failures);
+        put_u32(&data[10], s->timeouts);
+        put_u32(&data[14], s->retries);
+        put_u16(&data[18], s->min_us);
+        put_u16(&data[20], s->attempts ? s->total_us / s->attempts : 0);
+        put_u16(&data[22], s->max_us);
+    }
+    return true;
+}
+
+#    ifdef OLED_DRIVER_ENABLE
+static char *put_decimal(char *s, uint32_t value) {
+    char  digits[10];
+    char *d = digits;
+    do {
+        *d++ = '0' + value % 10;
+        value /= 10;
+    } while (value);
+    while (d > digits) {
+        *s++ = *--d;
+    }
+    return s;
+}
+
+/** \brief Write the link quality and the average time of transport_master() to the OLED
+ *
+ * For example "Link 99.8% 412us", to be called from oled_task_user() on the master.
+ */
+void split_stats_render_oled(void) {
+    const split_stats_t *scan    = &stats[SPLIT_STATS_SCAN];
+    uint16_t             quality = split_stats_quality();
+    char                 line[28];
+    char *               s = line;
+
+    memcpy(s, "Link ", 5);
+    s    = put_decimal(s + 5, quality / 10);
+    *s++ = '.';
+    s    = put_decimal(s, quality % 10);
+    *s++ = '%';
+    *s++ = ' ';
+    s    = put_decimal(s, scan->attempts ? scan->total_us / scan->attempts : 0);
+    memcpy(s, "us", 3);
+    oled_write_ln(line, false);
+}
+#    endif
+
+#endif
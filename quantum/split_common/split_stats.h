@@ -0,0 +1,89 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Health statistics of the split transport, kept by the master.
+ *
+ * Every transaction of the transport, and the whole of transport_master() as SPLIT_STATS_SCAN,
+ * counts its attempts, failures and timeouts, and keeps min/avg/max and a histogram of its
+ * durations in microseconds. Retries made by the serial driver within one attempt are counted
+ * for the transaction that is running. Histogram bucket 0 counts durations under 16us, bucket n
+ * (n > 0) 2^(n+3) to 2^(n+4) - 1us, and the last bucket everything longer.
+ *
+ * Only compiled in with SPLIT_TRANSPORT_STATS.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SPLIT_STATS_BUCKETS 14
+
+#ifndef SPLIT_STATS_RAW_HID_ID
+#    define SPLIT_STATS_RAW_HID_ID 0xF1
+#endif
+
+enum split_stats_transaction {
+    SPLIT_STATS_SCAN,            // transport_master(), a failure drops the other half for a scan
+    SPLIT_STATS_SEQUENCE,        // the change count of SPLIT_TRANSPORT_ON_CHANGE
+    SPLIT_STATS_MATRIX,          // the matrix, with serial including the encoders
+    SPLIT_STATS_ENCODERS,        // the encoders, with I2C
+    SPLIT_STATS_RGBLIGHT,        // the RGBLIGHT_SPLIT state
+    SPLIT_STATS_SYNC_TO_SLAVE,   // sync packets to the slave
+    SPLIT_STATS_SYNC_TO_MASTER,  // sync packets from the slave, with I2C also their status and acks
+    SPLIT_STATS_TRANSACTIONS
+};
+
+typedef enum {
+    SPLIT_STATS_OK,
+    SPLIT_STATS_ERROR,
+    SPLIT_STATS_TIMEOUT,
+} split_stats_result_t;
+
+typedef struct {
+    uint32_t attempts;
+    uint32_t failures;  // including the timeouts
+    uint32_t timeouts;
+    uint32_t retries;
+    uint32_t total_us;
+    uint16_t min_us;
+    uint16_t max_us;
+    uint16_t histogram[SPLIT_STATS_BUCKETS];
+} split_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Starts a transaction, returns the time to pass to split_stats_end().
+uint32_t split_stats_begin(uint8_t transaction);
+void     split_stats_end(uint8_t transaction, uint32_t start_us, split_stats_result_t result);
+// Called by the driver when it repeats the running transaction.
+void split_stats_retry(void);
+
+const split_stats_t *split_stats_get(uint8_t transaction);
+// Successful transactions per mille, over all but SPLIT_STATS_SCAN, 1000 before the first one.
+uint16_t split_stats_quality(void);
+void     split_stats_clear(void);
+void     split_stats_print(void);
+// Answers a SPLIT_STATS_RAW_HID_ID request in place, returns false for any other message.
+bool split_stats_raw_hid_receive(uint8_t *data, uint8_t length);
+// Writes a line with the quality and the average scan cost of the link.
+void split_stats_render_oled(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,250 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "split_sync.h"
+
+#if SPLIT_SYNC_BUDGET <= SPLIT_SYNC_RECORD_HEADER || SPLIT_SYNC_BUDGET > 255
+#    error SPLIT_SYNC_BUDGET must be between 4 and 255
+#endif
+
+#if SPLIT_SYNC_MAX_OBJECTS >= SPLIT_SYNC_INVALID
+#    error SPLIT_SYNC_MAX_OBJECTS must be below 255
+#endif
+
+typedef struct {
+    uint8_t *             data;
+    uint8_t *             shadow;  // NULL unless the object is SPLIT_SYNC_ON_CHANGE
+    split_sync_callback_t on_receive;
+    uint8_t               size;
+    uint8_t               direction;
+    bool                  dirty;
+    uint8_t               offset;      // the next byte to send
+    uint8_t               generation;  // incremented by every change, which restarts the transfer
+    uint8_t               sent_end;    // the end of the bytes in the packet in flight, 0 if none
+    uint8_t               sent_generation;
+} split_sync_object_t;
+
+typedef struct {
+    uint8_t in_flight;  // the sequence of the packet that waits for its ack, 0 if none
+    uint8_t last_ack;
+    uint8_t next;      // the object the next packet starts with
+    uint8_t received;  // the sequence of the last packet applied
+} split_sync_link_t;
+
+static split_sync_object_t objects[SPLIT_SYNC_MAX_OBJECTS];
+static uint8_t             object_count;
+static uint8_t             shadow_pool[SPLIT_SYNC_SHADOW_SIZE];
+static uint16_t            shadow_used;
+static split_sync_link_t   links[2];
+
+void split_sync_init(void) {
+    object_count = 0;
+    shadow_used  = 0;
+    memset(links, 0, sizeof(links));
+}
+
+uint8_t split_sync_register(void *data, uint8_t size, split_sync_direction_t direction, split_sync_policy_t policy, split_sync_callback_t on_receive) {
+    if (object_count == SPLIT_SYNC_MAX_OBJECTS || size == 0) {
+        return SPLIT_SYNC_INVALID;
+    }
+
+    split_sync_object_t *object = &objects[object_count];
+    object->shadow              = NULL;
+    if (policy == SPLIT_SYNC_ON_CHANGE) {
+        if (size > SPLIT_SYNC_SHADOW_SIZE - shadow_used) {
+            return SPLIT_SYNC_INVALID;
+        }
+        object->shadow = &shadow_pool[shadow_used];
+        shadow_used += size;
+        memcpy(object->shadow, data, size);
+    }
+    object->data       = data;
+    object->on_receive = on_receive;
+    object->size       = size;
+    object->direction  = direction;
+    object->dirty      = true;
+    object->offset     = 0;
+    object->generation = 0;
+    object->sent_end   = 0;
+    return object_count++;
+}
+
+static void restart(split_sync_object_t *object) {
+    object->dirty  = true;
+    object->offset = 0;
+    object->generation++;
+}
+
+void split_sync_mark_dirty(uint8_t id) {
+    if (id < object_count) {
+        restart(&objects[id]);
+    }
+}
+
+void split_sync_update(split_sync_direction_t direction) {
+    for (uint8_t id = 0; id < object_count; id++) {
+        split_sync_object_t *object = &objects[id];
+        if (object->direction == direction && object->shadow && memcmp(object->shadow, object->data, object->size)) {
+            memcpy(object->shadow, object->data, object->size);
+            restart(object);
+        }
+    }
+}
+
+bool split_sync_pending(split_sync_direction_t direction) {
+    if (links[direction].in_flight) {
+        return true;
+    }
+    for (uint8_t id = 0; id < object_count; id++) {
+        if (objects[id].direction == direction && objects[id].dirty) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool split_sync_registered(split_sync_direction_t direction) {
+    for (uint8_t id = 0; id < object_count; id++) {
+        if (objects[id].direction == direction) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Advances the objects past the bytes of the acknowledged packet, unless they have changed since.
+static void commit(split_sync_direction_t direction) {
+    for (uint8_t id = 0; id < object_count; id++) {
+        split_sync_object_t *object = &objects[id];
+        if (object->direction != direction || !object->sent_end) {
+            continue;
+        }
+        if (object->sent_generation == object->generation) {
+            object->offset = object->sent_end;
+            if (object->offset == object->size) {
+                object->offset = 0;
+                object->dirty  = false;
+            }
+        }
+        object->sent_end = 0;
+    }
+}
+
+bool split_sync_send(split_sync_direction_t direction, volatile split_sync_packet_t *packet, uint8_t ack) {
+    split_sync_link_t *link = &links[direction];
+
+    if (ack == 0 && link->last_ack != 0) {
+        // the receiver has restarted, and has lost what it received before
+        link->in_flight = 0;
+        for (uint8_t id = 0; id < object_count; id++) {
+            if (objects[id].direction == direction) {
+                objects[id].sent_end = 0;
+                restart(&objects[id]);
+            }
+        }
+    }
+    link->last_ack = ack;
+
+    if (link->in_flight) {
+        if (ack != link->in_flight) {
+            return true;
+        }
+        commit(direction);
+        link->in_flight = 0;
+    }
+
+    if (!object_count) {
+        return false;
+    }
+
+    // Round robin from the object after the last one sent, so that a large object cannot hold back the
+    // others, it continues from its offset when its turn comes again
+    uint8_t length = 0;
+    uint8_t next   = link->next;
+    for (uint8_t i = 0; i < object_count; i++) {
+        uint8_t              id     = (link->next + i) % object_count;
+        split_sync_object_t *object = &objects[id];
+        if (object->direction != direction || !object->dirty) {
+            continue;
+        }
+        if (length + SPLIT_SYNC_RECORD_HEADER >= SPLIT_SYNC_BUDGET) {
+            break;
+        }
+
+        uint8_t count = object->size - object->offset;
+        if (count > SPLIT_SYNC_BUDGET - SPLIT_SYNC_RECORD_HEADER - length) {
+            count = SPLIT_SYNC_BUDGET - SPLIT_SYNC_RECORD_HEADER - length;
+        }
+        packet->records[length++] = id;
+        packet->records[length++] = object->offset;
+        packet->records[length++] = count;
+        for (uint8_t j = 0; j < count; j++) {
+            packet->records[length++] = object->data[object->offset + j];
+        }
+        object->sent_end        = object->offset + count;
+        object->sent_generation = object->generation;
+        next                    = id + 1;
+    }
+    link->next = next % object_count;
+
+    if (!length) {
+        return false;
+    }
+    packet->length = length;
+    // anything but the sequence the receiver has already applied
+    link->in_flight  = (uint8_t)(ack + 1) ? ack + 1 : 1;
+    packet->sequence = link->in_flight;
+    return true;
+}
+
+uint8_t split_sync_receive(split_sync_direction_t direction, const volatile split_sync_packet_t *packet) {
+    split_sync_link_t *link     = &links[direction];
+    uint8_t            sequence = packet->sequence;
+
+    if (!sequence || sequence == link->received) {
+        return link->received;
+    }
+
+    uint16_t length = packet->length;
+    uint16_t i      = 0;
+    if (length > SPLIT_SYNC_BUDGET) {
+        length = 0;
+    }
+    while (i + SPLIT_SYNC_RECORD_HEADER <= length) {
+        uint8_t  id     = packet->records[i];
+        uint16_t offset = packet->records[i + 1];
+        uint16_t count  = packet->records[i + 2];
+        i += SPLIT_SYNC_RECORD_HEADER;
+        if (i + count > length) {
+            break;
+        }
+
+        split_sync_object_t *object = id < object_count ? &objects[id] : NULL;
+        if (object && object->direction == direction && offset + count <= object->size) {
+            for (uint8_t j = 0; j < count; j++) {
+                object->data[offset + j] = packet->records[i + j];
+            }
+            if (offset + count == object->size && object->on_receive) {
+                object->on_receive();
+            }
+        }
+        i += count;
+    }
+
+    link->received = sequence;
+    return sequence;
+}
@@ -0,0 +1,93 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Registry of the data that is kept in sync between the halves of a split keyboard.
+ *
+ * Both halves register the same objects in the same order, the index of an object is its id on
+ * the wire. An object is sent when it is dirty, in records of <id> <offset> <length> <bytes>
+ * packed into packets of at most SPLIT_SYNC_BUDGET bytes, so that large objects are spread over
+ * several scans and only a bounded amount of data is added to a scan. The transport sends one
+ * packet per direction at a time, which the receiver acknowledges with its sequence.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef SPLIT_SYNC_MAX_OBJECTS
+#    define SPLIT_SYNC_MAX_OBJECTS 8
+#endif
+
+// bytes of records in a packet, the most that is sent in each direction in one scan
+#ifndef SPLIT_SYNC_BUDGET
+#    define SPLIT_SYNC_BUDGET 12
+#endif
+
+// bytes for the copies that SPLIT_SYNC_ON_CHANGE objects are compared with
+#ifndef SPLIT_SYNC_SHADOW_SIZE
+#    define SPLIT_SYNC_SHADOW_SIZE 16
+#endif
+
+#define SPLIT_SYNC_RECORD_HEADER 3
+#define SPLIT_SYNC_INVALID 0xFF
+
+typedef enum {
+    SPLIT_SYNC_TO_SLAVE,
+    SPLIT_SYNC_TO_MASTER,
+} split_sync_direction_t;
+
+typedef enum {
+    SPLIT_SYNC_ON_CHANGE,  // compared with a copy every scan, sent when it differs
+    SPLIT_SYNC_ON_MARK,    // sent after split_sync_mark_dirty()
+} split_sync_policy_t;
+
+// called on the receiving half once the whole object has arrived
+typedef void (*split_sync_callback_t)(void);
+
+typedef struct {
+    uint8_t length;
+    uint8_t records[SPLIT_SYNC_BUDGET];
+    uint8_t sequence;  // last, so a packet that is written in order is complete once it changes
+} split_sync_packet_t;
+
+// Forgets all objects.
+void split_sync_init(void);
+
+// Returns the id of the object, or SPLIT_SYNC_INVALID when there is no room for it. The object
+// starts out dirty, size is at most 255 bytes.
+uint8_t split_sync_register(void *data, uint8_t size, split_sync_direction_t direction, split_sync_policy_t policy, split_sync_callback_t on_receive);
+
+// Sends the object again, on the half that sends it.
+void split_sync_mark_dirty(uint8_t id);
+
+/* Used by the transport, each half calls them every scan for its direction. */
+
+// Marks the SPLIT_SYNC_ON_CHANGE objects that have changed dirty.
+void split_sync_update(split_sync_direction_t direction);
+
+// Whether there are objects to send or a packet that waits for its ack.
+bool split_sync_pending(split_sync_direction_t direction);
+
+// Whether any objects are sent in the direction.
+bool split_sync_registered(split_sync_direction_t direction);
+
+// Takes the acknowledged sequence of the receiver. Returns true when the packet has to be sent,
+// which is either a new packet or the one that has not been acknowledged yet.
+bool split_sync_send(split_sync_direction_t direction, volatile split_sync_packet_t *packet, uint8_t ack);
+
+// Applies a packet that has not been applied before and returns the sequence to acknowledge.
+uint8_t split_sync_receive(split_sync_direction_t direction, const volatile split_sync_packet_t *packet);
@@ -0,0 +1,111 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Built for several matrix sizes, see rules.mk. */
+
+#include <cstring>
+#include "gtest/gtest.h"
+
+extern "C" {
+#define ROWS_PER_HAND (MATRIX_ROWS / 2)
+#include "matrix_pack.h"
+}
+
+#define ROW_BITS (sizeof(matrix_row_t) * 8)
+
+class MatrixPack : public ::testing::Test {
+   protected:
+    // packs rows and checks they come back unchanged, without writing past the packed size
+    void round_trip(void) {
+        memset(packed, 0xA5, sizeof(packed));
+        pack_matrix(packed, rows);
+        for (size_t i = PACKED_MATRIX_SIZE; i < sizeof(packed); i++) {
+            EXPECT_EQ(packed[i], 0xA5) << "byte " << i;
+        }
+        matrix_row_t unpacked[ROWS_PER_HAND];
+        memset(unpacked, 0x5A, sizeof(unpacked));
+        unpack_matrix(unpacked, packed);
+        for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+            EXPECT_EQ(unpacked[row], rows[row] & COL_MASK) << "row " << (int)row;
+        }
+    }
+
+    bool packed_bit(uint16_t bit) { return packed[bit / 8] & (1 << (bit % 8)); }
+
+    matrix_row_t rows[ROWS_PER_HAND] = {0};
+    uint8_t      packed[PACKED_MATRIX_SIZE + 4];
+};
+
+TEST_F(MatrixPack, SizeIsTheBitsOfOneHand) { EXPECT_EQ(PACKED_MATRIX_SIZE, (ROWS_PER_HAND * MATRIX_COLS + 7) / 8); }
+
+TEST_F(MatrixPack, NoKeys) {
+    round_trip();
+    for (uint8_t i = 0; i < PACKED_MATRIX_SIZE; i++) {
+        EXPECT_EQ(packed[i], 0);
+    }
+}
+
+TEST_F(MatrixPack, AllKeys) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        rows[row] = COL_MASK;
+    }
+    round_trip();
+    for (uint16_t bit = 0; bit < ROWS_PER_HAND * MATRIX_COLS; bit++) {
+        EXPECT_TRUE(packed_bit(bit)) << "bit " << bit;
+    }
+    // the padding of the last byte
+    for (uint16_t bit = ROWS_PER_HAND * MATRIX_COLS; bit < PACKED_MATRIX_SIZE * 8; bit++) {
+        EXPECT_FALSE(packed_bit(bit)) << "bit " << bit;
+    }
+}
+
+TEST_F(MatrixPack, EveryKeyHasItsOwnBit) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            memset(rows, 0, sizeof(rows));
+            rows[row] = (matrix_row_t)1 << col;
+            round_trip();
+            for (uint16_t bit = 0; bit < PACKED_MATRIX_SIZE * 8; bit++) {
+                EXPECT_EQ(packed_bit(bit), bit == row * MATRIX_COLS + col) << "row " << (int)row << " col " << (int)col << " bit " << bit;
+            }
+        }
+    }
+}
+
+TEST_F(MatrixPack, Patterns) {
+    uint32_t seed = 1;
+    for (int n = 0; n < 100; n++) {
+        for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+            seed      = seed * 1103515245 + 12345;
+            rows[row] = (matrix_row_t)((uint64_t)seed << 32 | seed * 2654435761u);
+        }
+        round_trip();
+    }
+}
+
+TEST_F(MatrixPack, BitsPastTheColumnsAreIgnored) {
+    // every bit of matrix_row_t is a column
+    if (MATRIX_COLS == ROW_BITS) {
+        return;
+    }
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        rows[row] = (matrix_row_t)~COL_MASK;
+    }
+    round_trip();
+    for (uint8_t i = 0; i < PACKED_MATRIX_SIZE; i++) {
+        EXPECT_EQ(packed[i], 0);
+    }
+}
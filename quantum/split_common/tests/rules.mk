@@ -0,0 +1,44 @@
+split_sync_DEFS := -DSPLIT_SYNC_BUDGET=12 -DSPLIT_SYNC_MAX_OBJECTS=4 -DSPLIT_SYNC_SHADOW_SIZE=8
+split_sync_SRC :=\
+	$(QUANTUM_PATH)/split_common/tests/split_sync_tests.cpp \
+	$(QUANTUM_PATH)/split_common/split_sync.c
+split_sync_INC := $(QUANTUM_PATH)/split_common
+
+serial_duplex_DEFS := -DTIMER_SIMULATION
+serial_duplex_SRC :=\
+	$(QUANTUM_PATH)/split_common/tests/serial_duplex_tests.cpp \
+	$(QUANTUM_PATH)/split_common/tests/serial_duplex_loopback.cpp \
+	$(QUANTUM_PATH)/split_common/serial_duplex.c \
+	$(TMK_PATH)/common/test/timer.c
+serial_duplex_INC := $(QUANTUM_PATH)/split_common $(DRIVER_PATH)/chibios
+
+split_stats_DEFS := -DSPLIT_TRANSPORT_STATS -DTIMER_SIMULATION -DNO_PRINT
+split_stats_SRC :=\
+	$(QUANTUM_PATH)/split_common/tests/split_stats_tests.cpp \
+	$(QUANTUM_PATH)/split_common/tests/serial_duplex_loopback.cpp \
+	$(QUANTUM_PATH)/split_common/serial_duplex.c \
+	$(QUANTUM_PATH)/split_common/split_stats.c \
+	$(TMK_PATH)/common/test/timer.c
+split_stats_INC := $(QUANTUM_PATH)/split_common $(DRIVER_PATH)/chibios
+
+# 7x9 per hand, columns that fit a byte, more than 16 columns, rows that need the 64 bit window
+# and every bit of a 32 bit row
+split_matrix_pack_7x9_DEFS := -DMATRIX_ROWS=14 -DMATRIX_COLS=9
+split_matrix_pack_7x9_SRC := $(QUANTUM_PATH)/split_common/tests/matrix_pack_tests.cpp
+split_matrix_pack_7x9_INC := $(QUANTUM_PATH)/split_common
+
+split_matrix_pack_8_DEFS := -DMATRIX_ROWS=10 -DMATRIX_COLS=8
+split_matrix_pack_8_SRC := $(QUANTUM_PATH)/split_common/tests/matrix_pack_tests.cpp
+split_matrix_pack_8_INC := $(QUANTUM_PATH)/split_common
+
+split_matrix_pack_20_DEFS := -DMATRIX_ROWS=8 -DMATRIX_COLS=20
+split_matrix_pack_20_SRC := $(QUANTUM_PATH)/split_common/tests/matrix_pack_tests.cpp
+split_matrix_pack_20_INC := $(QUANTUM_PATH)/split_common
+
+split_matrix_pack_27_DEFS := -DMATRIX_ROWS=6 -DMATRIX_COLS=27
+split_matrix_pack_27_SRC := $(QUANTUM_PATH)/split_common/tests/matrix_pack_tests.cpp
+split_matrix_pack_27_INC := $(QUANTUM_PATH)/split_common
+
+split_matrix_pack_32_DEFS := -DMATRIX_ROWS=12 -DMATRIX_COLS=32
+split_matrix_pack_32_SRC := $(QUANTUM_PATH)/split_common/tests/matrix_pack_tests.cpp
+split_matrix_pack_32_INC := $(QUANTUM_PATH)/split_common
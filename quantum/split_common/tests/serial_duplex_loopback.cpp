@@ -0,0 +1,93 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "serial_duplex_loopback.h"
+
+namespace loopback {
+
+Direction                 to_target;
+Direction                 to_initiator;
+std::function<void(void)> on_request;
+
+static SSTD_t *table;
+static uint8_t table_size;
+
+void Direction::send(const uint8_t *data, uint8_t size) {
+    frames++;
+    if (drop) {
+        if (!all) {
+            drop--;
+        }
+        return;
+    }
+    for (uint8_t i = 0; i < size; i++) {
+        wire.push_back(i == damage ? data[i] ^ 0x10 : data[i]);
+    }
+    if (!all) {
+        damage = -1;
+    }
+}
+
+// A receive that times out loses the bytes that did arrive, like the DMA of the port
+bool Direction::receive(uint8_t *data, uint8_t size) {
+    if (wire.size() < size) {
+        wire.clear();
+        return false;
+    }
+    for (uint8_t i = 0; i < size; i++) {
+        data[i] = wire.front();
+        wire.pop_front();
+    }
+    return true;
+}
+
+void reset(SSTD_t *target_table, uint8_t target_table_size) {
+    to_target    = Direction();
+    to_initiator = Direction();
+    on_request   = nullptr;
+    table        = target_table;
+    table_size   = target_table_size;
+}
+
+}  // namespace loopback
+
+using namespace loopback;
+
+extern "C" void advance_time(uint32_t ms);
+
+extern "C" bool serial_duplex_port_exchange(const uint8_t *tx, uint8_t tx_size, uint8_t *rx, uint8_t rx_size, uint16_t timeout) {
+    to_target.send(tx, tx_size);
+    while (!to_target.wire.empty()) {
+        if (on_request) {
+            on_request();
+        }
+        serial_duplex_target_task(table, table_size);
+    }
+    if (!to_initiator.receive(rx, rx_size)) {
+        advance_time(timeout);
+        return false;
+    }
+    return true;
+}
+
+extern "C" bool serial_duplex_port_receive(uint8_t *rx, uint8_t size, uint16_t timeout) { return to_target.receive(rx, size); }
+
+extern "C" bool serial_duplex_port_send(const uint8_t *tx, uint8_t size) {
+    to_initiator.send(tx, size);
+    return true;
+}
+
+extern "C" void serial_duplex_port_flush(void) { to_initiator.wire.clear(); }
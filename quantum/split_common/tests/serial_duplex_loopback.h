@@ -0,0 +1,53 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+extern "C" {
+#include "serial_duplex.h"
+}
+
+/* A stand-in for the port on the host. The initiator and the target run in the same thread: an
+ * exchange delivers the request to the target, runs the target on it and reads its response. The
+ * frames can be dropped or have a byte damaged on the way, in either direction. An exchange without
+ * a response takes the timeout.
+ */
+namespace loopback {
+
+struct Direction {
+    std::deque<uint8_t> wire;
+    uint32_t            frames = 0;
+    uint32_t            drop   = 0;  // the next frames to drop
+    int                 damage = -1; // the byte of the next frame to flip, if not negative
+    bool                all    = false;  // drop or damage every frame, not just the next ones
+
+    void send(const uint8_t *data, uint8_t size);
+    bool receive(uint8_t *data, uint8_t size);
+};
+
+extern Direction to_target;
+extern Direction to_initiator;
+
+// runs before the target reads each request
+extern std::function<void(void)> on_request;
+
+void reset(SSTD_t *target_table, uint8_t target_table_size);
+
+}  // namespace loopback
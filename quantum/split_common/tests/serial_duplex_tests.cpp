@@ -0,0 +1,158 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "gtest/gtest.h"
+#include "serial_duplex_loopback.h"
+
+/* A master and a slave transaction table, with one transaction that sends 3 bytes each way and
+ * one that only reads 4 bytes from the slave.
+ */
+class SerialDuplex : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        memset(master_status, 0, sizeof(master_status));
+        memset(slave_status, 0, sizeof(slave_status));
+        uint8_t m2s[3] = {1, 2, 3}, s2m[3] = {4, 5, 6}, s2m_only[4] = {7, 8, 9, 10};
+        memcpy(master_m2s, m2s, sizeof(m2s));
+        memset(master_s2m, 0, sizeof(master_s2m));
+        memset(master_s2m_only, 0, sizeof(master_s2m_only));
+        memset(slave_m2s, 0, sizeof(slave_m2s));
+        memcpy(slave_s2m, s2m, sizeof(s2m));
+        memcpy(slave_s2m_only, s2m_only, sizeof(s2m_only));
+        loopback::reset(slave, 2);
+    }
+
+    uint8_t master_status[2], slave_status[2];
+    uint8_t master_m2s[3], master_s2m[3], master_s2m_only[4];
+    uint8_t slave_m2s[3], slave_s2m[3], slave_s2m_only[4];
+
+    SSTD_t master[2] = {
+        {&master_status[0], sizeof(master_m2s), master_m2s, sizeof(master_s2m), master_s2m},
+        {&master_status[1], 0, NULL, sizeof(master_s2m_only), master_s2m_only},
+    };
+    SSTD_t slave[2] = {
+        {&slave_status[0], sizeof(slave_m2s), slave_m2s, sizeof(slave_s2m), slave_s2m},
+        {&slave_status[1], 0, NULL, sizeof(slave_s2m_only), slave_s2m_only},
+    };
+};
+
+TEST_F(SerialDuplex, CrcMatchesReference) {
+    const uint8_t check[] = "123456789";
+    EXPECT_EQ(serial_duplex_crc16(check, 9), 0x29B1);
+}
+
+TEST_F(SerialDuplex, TransactionCopiesBothWays) {
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_END);
+    EXPECT_EQ(memcmp(slave_m2s, master_m2s, sizeof(slave_m2s)), 0);
+    EXPECT_EQ(memcmp(master_s2m, slave_s2m, sizeof(master_s2m)), 0);
+    EXPECT_EQ(master_status[0], TRANSACTION_END);
+    EXPECT_EQ(slave_status[0], TRANSACTION_ACCEPTED);
+    EXPECT_EQ(loopback::to_target.frames, 1);
+    EXPECT_EQ(loopback::to_initiator.frames, 1);
+
+    EXPECT_EQ(serial_duplex_transaction(&master[1], 1), TRANSACTION_END);
+    EXPECT_EQ(memcmp(master_s2m_only, slave_s2m_only, sizeof(master_s2m_only)), 0);
+    EXPECT_EQ(slave_status[1], TRANSACTION_ACCEPTED);
+}
+
+TEST_F(SerialDuplex, DamagedRequestIsSentAgain) {
+    for (int byte = 0; byte < 3 + SERIAL_DUPLEX_OVERHEAD; byte++) {
+        SCOPED_TRACE(byte);
+        loopback::to_target.frames = 0;
+        loopback::to_target.damage = byte;
+        master_m2s[0]++;
+        EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_END);
+        EXPECT_EQ(loopback::to_target.frames, 2);
+        EXPECT_EQ(slave_m2s[0], master_m2s[0]);
+    }
+}
+
+TEST_F(SerialDuplex, DamagedResponseIsReadAgain) {
+    loopback::to_initiator.damage = SERIAL_DUPLEX_HEADER_SIZE + 1;
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_END);
+    EXPECT_EQ(loopback::to_initiator.frames, 2);
+    EXPECT_EQ(memcmp(master_s2m, slave_s2m, sizeof(master_s2m)), 0);
+}
+
+TEST_F(SerialDuplex, RepeatedRequestIsAppliedOnce) {
+    loopback::to_initiator.drop = 1;
+    int requests                = 0;
+    loopback::on_request        = [&]() {
+        // what the target does with the second copy of the request
+        if (requests++ == 1) {
+            slave_m2s[0]    = 0;
+            slave_status[0] = 0;
+        }
+    };
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_END);
+    EXPECT_EQ(requests, 2);
+    EXPECT_EQ(slave_m2s[0], 0);
+    EXPECT_EQ(slave_status[0], 0);
+    EXPECT_EQ(memcmp(master_s2m, slave_s2m, sizeof(master_s2m)), 0);
+
+    // the next transaction is new again
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_END);
+    EXPECT_EQ(slave_m2s[0], 1);
+}
+
+TEST_F(SerialDuplex, NewRequestAfterAnOutageIsApplied) {
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_END);
+
+    // enough failed transactions to bring the sequence back to that of the last request
+    loopback::to_target.drop = 1;
+    loopback::to_target.all  = true;
+    for (int i = 0; i < 15; i++) {
+        EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_NO_RESPONSE);
+    }
+    loopback::reset(slave, 2);
+
+    master_m2s[0]   = 42;
+    slave_status[0] = 0;
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_END);
+    EXPECT_EQ(slave_m2s[0], 42);
+    EXPECT_EQ(slave_status[0], TRANSACTION_ACCEPTED);
+}
+
+TEST_F(SerialDuplex, NoiseBeforeRequestIsSkipped) {
+    const uint8_t noise[] = {0x00, SERIAL_DUPLEX_SYNC, 0x00, 0xFF, 0x13};
+    loopback::to_target.wire.assign(noise, noise + sizeof(noise));
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_END);
+    EXPECT_EQ(loopback::to_target.frames, 1);
+    EXPECT_EQ(memcmp(slave_m2s, master_m2s, sizeof(slave_m2s)), 0);
+}
+
+TEST_F(SerialDuplex, BrokenLinkFails) {
+    loopback::to_target.drop = 1;
+    loopback::to_target.all  = true;
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_NO_RESPONSE);
+    EXPECT_EQ(loopback::to_target.frames, SERIAL_DUPLEX_RETRIES + 1);
+    EXPECT_EQ(master_status[0], TRANSACTION_NO_RESPONSE);
+    EXPECT_EQ(slave_status[0], 0);
+
+    loopback::reset(slave, 2);
+    loopback::to_initiator.damage = 0;
+    loopback::to_initiator.all    = true;
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0), TRANSACTION_DATA_ERROR);
+    EXPECT_EQ(loopback::to_initiator.frames, SERIAL_DUPLEX_RETRIES + 1);
+}
+
+TEST_F(SerialDuplex, UnknownTransactionIsIgnored) {
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 0x10), TRANSACTION_TYPE_ERROR);
+    // the slave has no transaction 2
+    EXPECT_EQ(serial_duplex_transaction(&master[0], 2), TRANSACTION_NO_RESPONSE);
+    EXPECT_EQ(slave_status[0], 0);
+}
@@ -0,0 +1,130 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include "gtest/gtest.h"
+#include "serial_duplex_loopback.h"
+
+extern "C" {
+#include "split_stats.h"
+
+void advance_time_us(uint32_t us);
+}
+
+class SplitStats : public ::testing::Test {
+   protected:
+    void SetUp() override { split_stats_clear(); }
+
+    void run(uint8_t transaction, uint32_t us, split_stats_result_t result) {
+        uint32_t start = split_stats_begin(transaction);
+        advance_time_us(us);
+        split_stats_end(transaction, start, result);
+    }
+};
+
+TEST_F(SplitStats, RecordsDurations) {
+    run(SPLIT_STATS_MATRIX, 100, SPLIT_STATS_OK);
+    run(SPLIT_STATS_MATRIX, 300, SPLIT_STATS_OK);
+    run(SPLIT_STATS_MATRIX, 200, SPLIT_STATS_OK);
+
+    const split_stats_t *s = split_stats_get(SPLIT_STATS_MATRIX);
+    EXPECT_EQ(s->attempts, 3);
+    EXPECT_EQ(s->failures, 0);
+    EXPECT_EQ(s->min_us, 100);
+    EXPECT_EQ(s->max_us, 300);
+    EXPECT_EQ(s->total_us, 600);
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_SYNC_TO_SLAVE)->attempts, 0);
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_TRANSACTIONS), nullptr);
+}
+
+TEST_F(SplitStats, HistogramBuckets) {
+    const struct {
+        uint32_t us;
+        uint8_t  bucket;
+    } cases[] = {{0, 0}, {15, 0}, {16, 1}, {31, 1}, {32, 2}, {1000, 6}, {65535, 12}, {65536, 13}, {100000, 13}};
+    for (auto c : cases) {
+        SCOPED_TRACE(c.us);
+        split_stats_clear();
+        run(SPLIT_STATS_SCAN, c.us, SPLIT_STATS_OK);
+        EXPECT_EQ(split_stats_get(SPLIT_STATS_SCAN)->histogram[c.bucket], 1);
+    }
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_SCAN)->max_us, UINT16_MAX);
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_SCAN)->total_us, 100000);
+}
+
+TEST_F(SplitStats, FailuresAndQuality) {
+    EXPECT_EQ(split_stats_quality(), 1000);
+    for (int i = 0; i < 997; i++) {
+        run(SPLIT_STATS_MATRIX, 50, SPLIT_STATS_OK);
+    }
+    run(SPLIT_STATS_MATRIX, 50, SPLIT_STATS_ERROR);
+    run(SPLIT_STATS_SYNC_TO_MASTER, 50, SPLIT_STATS_TIMEOUT);
+    run(SPLIT_STATS_SYNC_TO_MASTER, 50, SPLIT_STATS_OK);
+    // dropped scans are made of failed transactions, which are already counted
+    run(SPLIT_STATS_SCAN, 50, SPLIT_STATS_ERROR);
+
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_MATRIX)->failures, 1);
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_MATRIX)->timeouts, 0);
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_SYNC_TO_MASTER)->failures, 1);
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_SYNC_TO_MASTER)->timeouts, 1);
+    EXPECT_EQ(split_stats_quality(), 998);
+}
+
+TEST_F(SplitStats, DriverRetriesCount) {
+    uint8_t slave_status = 0, master_status = 0, slave_data[2] = {1, 2}, master_data[2] = {};
+    SSTD_t  slave        = {&slave_status, 0, NULL, sizeof(slave_data), slave_data};
+    SSTD_t  master       = {&master_status, 0, NULL, sizeof(master_data), master_data};
+    loopback::reset(&slave, 1);
+    loopback::to_initiator.drop = 2;
+
+    uint32_t start = split_stats_begin(SPLIT_STATS_MATRIX);
+    EXPECT_EQ(serial_duplex_transaction(&master, 0), TRANSACTION_END);
+    split_stats_end(SPLIT_STATS_MATRIX, start, SPLIT_STATS_OK);
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_MATRIX)->retries, 2);
+
+    // not while no transaction of the transport is running
+    loopback::to_initiator.drop = 1;
+    EXPECT_EQ(serial_duplex_transaction(&master, 0), TRANSACTION_END);
+    EXPECT_EQ(split_stats_get(SPLIT_STATS_MATRIX)->retries, 2);
+}
+
+TEST_F(SplitStats, RawHid) {
+    run(SPLIT_STATS_SEQUENCE, 20, SPLIT_STATS_OK);
+    run(SPLIT_STATS_SEQUENCE, 40, SPLIT_STATS_TIMEOUT);
+    split_stats_retry();
+
+    uint8_t data[32] = {SPLIT_STATS_RAW_HID_ID, 0xFF};
+    EXPECT_TRUE(split_stats_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[2], SPLIT_STATS_TRANSACTIONS);
+    EXPECT_EQ(data[3] << 8 | data[4], 500);
+
+    uint8_t counters[32] = {SPLIT_STATS_RAW_HID_ID, SPLIT_STATS_SEQUENCE};
+    EXPECT_TRUE(split_stats_raw_hid_receive(counters, sizeof(counters)));
+    const uint8_t expected[] = {SPLIT_STATS_RAW_HID_ID, SPLIT_STATS_SEQUENCE, 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 20, 0, 30, 0, 40};
+    EXPECT_EQ(memcmp(counters, expected, sizeof(expected)), 0);
+
+    uint8_t histogram[32] = {SPLIT_STATS_RAW_HID_ID, 0x80 | SPLIT_STATS_SEQUENCE};
+    EXPECT_TRUE(split_stats_raw_hid_receive(histogram, sizeof(histogram)));
+    EXPECT_EQ(histogram[2 + 2 * 1 + 1], 1);
+    EXPECT_EQ(histogram[2 + 2 * 2 + 1], 1);
+
+    uint8_t unknown[32] = {SPLIT_STATS_RAW_HID_ID, SPLIT_STATS_TRANSACTIONS};
+    EXPECT_TRUE(split_stats_raw_hid_receive(unknown, sizeof(unknown)));
+    EXPECT_EQ(unknown[1], 0xFE);
+
+    uint8_t other[32] = {0x01};
+    EXPECT_FALSE(split_stats_raw_hid_receive(other, sizeof(other)));
+}
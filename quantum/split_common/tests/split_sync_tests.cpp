@@ -0,0 +1,245 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "split_sync.h"
+}
+
+static int callbacks;
+
+static void on_receive(void) { callbacks++; }
+
+/* The other half: a copy of every object, updated from the records of the packets. */
+class SplitSync : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        split_sync_init();
+        memset(&packet, 0, sizeof(packet));
+        callbacks = 0;
+    }
+
+    uint8_t add(void *data, uint8_t size, split_sync_direction_t direction, split_sync_policy_t policy) {
+        uint8_t id = split_sync_register(data, size, direction, policy, on_receive);
+        if (id != SPLIT_SYNC_INVALID) {
+            peer.resize(id + 1);
+            peer[id].assign(size, 0);
+        }
+        return id;
+    }
+
+    // returns the ids of the records in the packet, in order
+    std::vector<uint8_t> deliver(void) {
+        std::vector<uint8_t> ids;
+        EXPECT_LE(packet.length, SPLIT_SYNC_BUDGET);
+        for (uint8_t i = 0; i < packet.length;) {
+            uint8_t id = packet.records[i], offset = packet.records[i + 1], count = packet.records[i + 2];
+            EXPECT_GT(count, 0);
+            EXPECT_LE(offset + count, peer[id].size());
+            memcpy(&peer[id][offset], &packet.records[i + SPLIT_SYNC_RECORD_HEADER], count);
+            ids.push_back(id);
+            i += SPLIT_SYNC_RECORD_HEADER + count;
+        }
+        return ids;
+    }
+
+    // sends, delivers and acknowledges packets until nothing is left, returns how many it took
+    int sync(void) {
+        int count = 0;
+        while (split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack)) {
+            deliver();
+            ack = packet.sequence;
+            count++;
+        }
+        return count;
+    }
+
+    split_sync_packet_t               packet;
+    uint8_t                           ack = 0;
+    std::vector<std::vector<uint8_t>> peer;
+};
+
+TEST_F(SplitSync, SmallObjectsShareAPacket) {
+    uint8_t a[2] = {1, 2};
+    uint8_t b    = 3;
+    EXPECT_EQ(add(a, sizeof(a), SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE), 0);
+    EXPECT_EQ(add(&b, sizeof(b), SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE), 1);
+
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_EQ(packet.length, 2 * SPLIT_SYNC_RECORD_HEADER + 3);
+    EXPECT_NE(packet.sequence, ack);
+    EXPECT_EQ(deliver(), std::vector<uint8_t>({0, 1}));
+    EXPECT_EQ(peer[0], std::vector<uint8_t>({1, 2}));
+    EXPECT_EQ(peer[1], std::vector<uint8_t>({3}));
+
+    // sent again until it is acknowledged, then there is nothing left
+    split_sync_packet_t sent = packet;
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_EQ(memcmp(&sent, &packet, sizeof(packet)), 0);
+    EXPECT_TRUE(split_sync_pending(SPLIT_SYNC_TO_SLAVE));
+    ack = packet.sequence;
+    EXPECT_FALSE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_FALSE(split_sync_pending(SPLIT_SYNC_TO_SLAVE));
+    EXPECT_TRUE(split_sync_registered(SPLIT_SYNC_TO_SLAVE));
+    EXPECT_FALSE(split_sync_registered(SPLIT_SYNC_TO_MASTER));
+}
+
+TEST_F(SplitSync, OnlyChangedObjectsAreSent) {
+    uint8_t a = 1, b = 2, c = 3;
+    add(&a, 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE);
+    add(&b, 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE);
+    add(&c, 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_MARK);
+    EXPECT_EQ(sync(), 1);
+
+    b = 5;
+    c = 6;
+    EXPECT_EQ(sync(), 0);
+    split_sync_update(SPLIT_SYNC_TO_SLAVE);
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_EQ(deliver(), std::vector<uint8_t>({1}));
+    EXPECT_EQ(peer[1][0], 5);
+    ack = packet.sequence;
+
+    split_sync_mark_dirty(2);
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_EQ(deliver(), std::vector<uint8_t>({2}));
+    EXPECT_EQ(peer[2][0], 6);
+}
+
+TEST_F(SplitSync, LargeObjectIsSpreadOverPackets) {
+    uint8_t big[30];
+    for (uint8_t i = 0; i < sizeof(big); i++) {
+        big[i] = i + 1;
+    }
+    add(big, sizeof(big), SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_MARK);
+    // 9 bytes of data and a header in each packet
+    EXPECT_EQ(sync(), 4);
+    EXPECT_EQ(memcmp(peer[0].data(), big, sizeof(big)), 0);
+}
+
+TEST_F(SplitSync, LargeObjectDoesNotHoldBackOthers) {
+    uint8_t big[30] = {0};
+    uint8_t small   = 7;
+    add(big, sizeof(big), SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_MARK);
+    add(&small, 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE);
+
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_EQ(deliver(), std::vector<uint8_t>({0}));
+    ack = packet.sequence;
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_EQ(deliver(), std::vector<uint8_t>({1, 0}));
+    EXPECT_EQ(peer[1][0], 7);
+}
+
+TEST_F(SplitSync, ChangeRestartsTransfer) {
+    uint8_t big[20];
+    memset(big, 1, sizeof(big));
+    add(big, sizeof(big), SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_MARK);
+
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    deliver();
+    memset(big, 2, sizeof(big));
+    split_sync_mark_dirty(0);
+    ack = packet.sequence;
+
+    // the packet with the old bytes is acknowledged after the change, the transfer starts over
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_EQ(packet.records[1], 0);
+    deliver();
+    ack = packet.sequence;
+    EXPECT_EQ(sync(), 2);
+    EXPECT_EQ(peer[0], std::vector<uint8_t>(sizeof(big), 2));
+}
+
+TEST_F(SplitSync, ReceiverRestartSendsEverythingAgain) {
+    uint8_t a = 1, b = 2;
+    add(&a, 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE);
+    add(&b, 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_MARK);
+    EXPECT_EQ(sync(), 1);
+
+    peer[0][0] = peer[1][0] = 0;
+    ack                     = 0;
+    ASSERT_TRUE(split_sync_send(SPLIT_SYNC_TO_SLAVE, &packet, ack));
+    EXPECT_NE(packet.sequence, 0);
+    EXPECT_EQ(deliver(), std::vector<uint8_t>({0, 1}));
+    EXPECT_EQ(peer[0][0], 1);
+    EXPECT_EQ(peer[1][0], 2);
+}
+
+TEST_F(SplitSync, ReceivedOnceWithCallbackWhenComplete) {
+    uint8_t data[12] = {0};
+    add(data, sizeof(data), SPLIT_SYNC_TO_MASTER, SPLIT_SYNC_ON_MARK);
+
+    // the first 9 bytes, then the rest
+    uint8_t first[] = {0, 0, 9, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    packet.length   = sizeof(first);
+    memcpy(packet.records, first, sizeof(first));
+    packet.sequence = 4;
+    EXPECT_EQ(split_sync_receive(SPLIT_SYNC_TO_MASTER, &packet), 4);
+    EXPECT_EQ(data[8], 9);
+    EXPECT_EQ(callbacks, 0);
+
+    uint8_t rest[]  = {0, 9, 3, 10, 11, 12};
+    packet.length   = sizeof(rest);
+    memcpy(packet.records, rest, sizeof(rest));
+    packet.sequence = 5;
+    EXPECT_EQ(split_sync_receive(SPLIT_SYNC_TO_MASTER, &packet), 5);
+    EXPECT_EQ(data[11], 12);
+    EXPECT_EQ(callbacks, 1);
+
+    // a packet that was sent again is not applied twice
+    data[11] = 0;
+    EXPECT_EQ(split_sync_receive(SPLIT_SYNC_TO_MASTER, &packet), 5);
+    EXPECT_EQ(data[11], 0);
+    EXPECT_EQ(callbacks, 1);
+}
+
+TEST_F(SplitSync, InvalidRecordsAreIgnored) {
+    uint8_t mine = 0, theirs = 0;
+    add(&mine, 1, SPLIT_SYNC_TO_MASTER, SPLIT_SYNC_ON_MARK);
+    add(&theirs, 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_MARK);
+
+    // an unknown id, the wrong direction and past the end of the object
+    uint8_t records[] = {9, 0, 1, 1, 1, 0, 1, 1, 0, 1, 1, 1};
+    packet.length     = sizeof(records);
+    memcpy(packet.records, records, sizeof(records));
+    packet.sequence = 1;
+    EXPECT_EQ(split_sync_receive(SPLIT_SYNC_TO_MASTER, &packet), 1);
+
+    // past the end of the packet
+    uint8_t truncated[] = {0, 0, 4, 1};
+    packet.length       = sizeof(truncated);
+    memcpy(packet.records, truncated, sizeof(truncated));
+    packet.sequence = 2;
+    EXPECT_EQ(split_sync_receive(SPLIT_SYNC_TO_MASTER, &packet), 2);
+    EXPECT_EQ(mine, 0);
+    EXPECT_EQ(theirs, 0);
+    EXPECT_EQ(callbacks, 0);
+}
+
+TEST_F(SplitSync, RegistrationIsLimited) {
+    uint8_t big[SPLIT_SYNC_SHADOW_SIZE + 1] = {0};
+    uint8_t data[SPLIT_SYNC_MAX_OBJECTS]    = {0};
+    EXPECT_EQ(add(big, sizeof(big), SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE), SPLIT_SYNC_INVALID);
+    EXPECT_EQ(add(big, 0, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_MARK), SPLIT_SYNC_INVALID);
+    for (uint8_t i = 0; i < SPLIT_SYNC_MAX_OBJECTS; i++) {
+        EXPECT_EQ(add(&data[i], 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE), i);
+    }
+    EXPECT_EQ(add(big, 1, SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_MARK), SPLIT_SYNC_INVALID);
+}
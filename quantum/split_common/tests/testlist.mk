@@ -0,0 +1,9 @@
+TEST_LIST +=\
+	split_sync\
+	serial_duplex\
+	split_stats\
+	split_matrix_pack_7x9\
+	split_matrix_pack_8\
+	split_matrix_pack_20\
+	split_matrix_pack_27\
+	split_matrix_pack_32
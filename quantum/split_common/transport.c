@@ -4,9 +4,15 @@
 #include "config.h"
 #include "matrix.h"
 #include "quantum.h"
+#include "split_sync.h"
+#ifdef SPLIT_TRANSPORT_STATS
+#    include "split_stats.h"
+#endif
 
 #define ROWS_PER_HAND (MATRIX_ROWS / 2)
 
+#include "matrix_pack.h"
+
 #ifdef RGBLIGHT_ENABLE
 #    include "rgblight.h"
 #endif
@@ -21,32 +27,70 @@ static pin_t encoders_pad[] = ENCODERS_PAD_A;
 #    define NUMBER_OF_ENCODERS (sizeof(encoders_pad) / sizeof(pin_t))
 #endif
 
+#ifdef BACKLIGHT_ENABLE
+static uint8_t split_backlight_level;
+static void    split_backlight_received(void) { backlight_set(split_backlight_level); }
+#endif
+
+#ifdef WPM_ENABLE
+static uint8_t split_current_wpm;
+static void    split_wpm_received(void) { set_current_wpm(split_current_wpm); }
+#endif
+
+// Both halves register the sync objects of the core features, in the same order
+static void transport_sync_init(void) {
+#ifdef BACKLIGHT_ENABLE
+    split_sync_register(&split_backlight_level, sizeof(split_backlight_level), SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE, split_backlight_received);
+#endif
+#ifdef WPM_ENABLE
+    split_sync_register(&split_current_wpm, sizeof(split_current_wpm), SPLIT_SYNC_TO_SLAVE, SPLIT_SYNC_ON_CHANGE, split_wpm_received);
+#endif
+}
+
+static void transport_sync_update_master(void) {
+#ifdef BACKLIGHT_ENABLE
+    split_backlight_level = is_backlight_enabled() ? get_backlight_level() : 0;
+#endif
+#ifdef WPM_ENABLE
+    split_current_wpm = get_current_wpm();
+#endif
+    split_sync_update(SPLIT_SYNC_TO_SLAVE);
+}
+
 #if defined(USE_I2C)
 
 #    include "i2c_master.h"
 #    include "i2c_slave.h"
 
 typedef struct _I2C_slave_buffer_t {
-    matrix_row_t smatrix[ROWS_PER_HAND];
-    uint8_t      backlight_level;
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    uint8_t sequence;  // incremented by the slave when smatrix or encoder_state change
+#    endif
+    uint8_t smatrix[PACKED_MATRIX_SIZE];
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     rgblight_syncinfo_t rgblight_sync;
 #    endif
 #    ifdef ENCODER_ENABLE
     uint8_t encoder_state[NUMBER_OF_ENCODERS];
 #    endif
-#    ifdef WPM_ENABLE
-    uint8_t current_wpm;
-#    endif
+    uint8_t             sync_ack;       // the last packet from the slave that the master applied
+    uint8_t             sync_status[2];  // the last packet from the master that the slave applied, and the sequence of sync_to_master
+    split_sync_packet_t sync_to_slave;
+    split_sync_packet_t sync_to_master;
 } I2C_slave_buffer_t;
 
+_Static_assert(sizeof(I2C_slave_buffer_t) <= I2C_SLAVE_REG_COUNT, "I2C_slave_buffer_t does not fit into i2c_slave_reg, raise I2C_SLAVE_REG_COUNT or lower SPLIT_SYNC_BUDGET");
+
 static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_reg;
 
-#    define I2C_BACKLIGHT_START offsetof(I2C_slave_buffer_t, backlight_level)
+#    define I2C_SEQUENCE_START offsetof(I2C_slave_buffer_t, sequence)
 #    define I2C_RGB_START offsetof(I2C_slave_buffer_t, rgblight_sync)
 #    define I2C_KEYMAP_START offsetof(I2C_slave_buffer_t, smatrix)
 #    define I2C_ENCODER_START offsetof(I2C_slave_buffer_t, encoder_state)
-#    define I2C_WPM_START offsetof(I2C_slave_buffer_t, current_wpm)
+#    define I2C_SYNC_ACK_START offsetof(I2C_slave_buffer_t, sync_ack)
+#    define I2C_SYNC_STATUS_START offsetof(I2C_slave_buffer_t, sync_status)
+#    define I2C_SYNC_TO_SLAVE_START offsetof(I2C_slave_buffer_t, sync_to_slave)
+#    define I2C_SYNC_TO_MASTER_START offsetof(I2C_slave_buffer_t, sync_to_master)
 
 #    define TIMEOUT 100
 
@@ -54,53 +98,148 @@ static I2C_slave_buffer_t *const i2c_buffer = (I2C_slave_buffer_t *)i2c_slave_re
 #        define SLAVE_I2C_ADDRESS 0x32
 #    endif
 
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+static uint8_t last_sequence;
+static bool    slave_synced = false;
+#    endif
+
+// The register accesses of the master, counted for the transaction they are part of
+#    ifdef SPLIT_TRANSPORT_STATS
+static split_stats_result_t i2c_result(i2c_status_t status) {
+    if (status == I2C_STATUS_SUCCESS) {
+        return SPLIT_STATS_OK;
+    }
+    return status == I2C_STATUS_TIMEOUT ? SPLIT_STATS_TIMEOUT : SPLIT_STATS_ERROR;
+}
+
+static i2c_status_t read_reg(uint8_t transaction, uint8_t reg, void *data, uint16_t length) {
+    uint32_t     start  = split_stats_begin(transaction);
+    i2c_status_t status = i2c_readReg(SLAVE_I2C_ADDRESS, reg, data, length, TIMEOUT);
+    split_stats_end(transaction, start, i2c_result(status));
+    return status;
+}
+
+static i2c_status_t write_reg(uint8_t transaction, uint8_t reg, const void *data, uint16_t length) {
+    uint32_t     start  = split_stats_begin(transaction);
+    i2c_status_t status = i2c_writeReg(SLAVE_I2C_ADDRESS, reg, data, length, TIMEOUT);
+    split_stats_end(transaction, start, i2c_result(status));
+    return status;
+}
+#    else
+#        define read_reg(transaction, reg, data, length) i2c_readReg(SLAVE_I2C_ADDRESS, reg, data, length, TIMEOUT)
+#        define write_reg(transaction, reg, data, length) i2c_writeReg(SLAVE_I2C_ADDRESS, reg, data, length, TIMEOUT)
+#    endif
+
+// The master uses its own i2c_buffer for the packets, sync_to_slave keeps the packet until the
+// slave acknowledges it. The status is only read when there is something to send or to receive.
+static void transport_sync_master(void) {
+    transport_sync_update_master();
+    if (!split_sync_pending(SPLIT_SYNC_TO_SLAVE) && !split_sync_registered(SPLIT_SYNC_TO_MASTER)) {
+        return;
+    }
+
+    uint8_t status[2];
+    if (read_reg(SPLIT_STATS_SYNC_TO_MASTER, I2C_SYNC_STATUS_START, status, sizeof(status)) < 0) {
+        return;
+    }
+    if (split_sync_send(SPLIT_SYNC_TO_SLAVE, &i2c_buffer->sync_to_slave, status[0])) {
+        write_reg(SPLIT_STATS_SYNC_TO_SLAVE, I2C_SYNC_TO_SLAVE_START, (void *)&i2c_buffer->sync_to_slave, sizeof(i2c_buffer->sync_to_slave));
+    }
+    if (status[1] != i2c_buffer->sync_ack && read_reg(SPLIT_STATS_SYNC_TO_MASTER, I2C_SYNC_TO_MASTER_START, (void *)&i2c_buffer->sync_to_master, sizeof(i2c_buffer->sync_to_master)) >= 0) {
+        uint8_t ack = split_sync_receive(SPLIT_SYNC_TO_MASTER, &i2c_buffer->sync_to_master);
+        // read the packet again next scan if the slave has not got the ack
+        if (write_reg(SPLIT_STATS_SYNC_TO_MASTER, I2C_SYNC_ACK_START, &ack, sizeof(ack)) >= 0) {
+            i2c_buffer->sync_ack = ack;
+        }
+    }
+}
+
+static void transport_sync_slave(void) {
+    i2c_buffer->sync_status[0] = split_sync_receive(SPLIT_SYNC_TO_SLAVE, &i2c_buffer->sync_to_slave);
+    split_sync_update(SPLIT_SYNC_TO_MASTER);
+    split_sync_send(SPLIT_SYNC_TO_MASTER, &i2c_buffer->sync_to_master, i2c_buffer->sync_ack);
+    // after the packet it announces, the I2C interrupt may read the buffer in between
+    __asm__ volatile("" ::: "memory");
+    *(volatile uint8_t *)&i2c_buffer->sync_status[1] = i2c_buffer->sync_to_master.sequence;
+}
+
 // Get rows from other half over i2c
-bool transport_master(matrix_row_t matrix[]) {
-    i2c_readReg(SLAVE_I2C_ADDRESS, I2C_KEYMAP_START, (void *)matrix, sizeof(i2c_buffer->smatrix), TIMEOUT);
-
-    // write backlight info
-#    ifdef BACKLIGHT_ENABLE
-    uint8_t level = is_backlight_enabled() ? get_backlight_level() : 0;
-    if (level != i2c_buffer->backlight_level) {
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_BACKLIGHT_START, (void *)&level, sizeof(level), TIMEOUT) >= 0) {
-            i2c_buffer->backlight_level = level;
+static bool master_transfer(matrix_row_t matrix[]) {
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    // Only read the rows when the slave has changed them since the last read
+    uint8_t sequence;
+    if (read_reg(SPLIT_STATS_SEQUENCE, I2C_SEQUENCE_START, &sequence, sizeof(sequence)) < 0) {
+        slave_synced = false;
+        return false;
+    }
+    if (!slave_synced || sequence != last_sequence) {
+        // a failed read may have left part of the buffer overwritten, keep the last rows
+        if (read_reg(SPLIT_STATS_MATRIX, I2C_KEYMAP_START, i2c_buffer->smatrix, sizeof(i2c_buffer->smatrix)) < 0) {
+            slave_synced = false;
+            return false;
+        }
+#        ifdef ENCODER_ENABLE
+        if (read_reg(SPLIT_STATS_ENCODERS, I2C_ENCODER_START, (void *)i2c_buffer->encoder_state, sizeof(i2c_buffer->encoder_state)) < 0) {
+            slave_synced = false;
+            return false;
         }
+        encoder_update_raw(i2c_buffer->encoder_state);
+#        endif
+        unpack_matrix(matrix, i2c_buffer->smatrix);
+        slave_synced  = true;
+        last_sequence = sequence;
     }
+#    else
+    read_reg(SPLIT_STATS_MATRIX, I2C_KEYMAP_START, i2c_buffer->smatrix, sizeof(i2c_buffer->smatrix));
+    unpack_matrix(matrix, i2c_buffer->smatrix);
 #    endif
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     if (rgblight_get_change_flags()) {
         rgblight_syncinfo_t rgblight_sync;
         rgblight_get_syncinfo(&rgblight_sync);
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_RGB_START, (void *)&rgblight_sync, sizeof(rgblight_sync), TIMEOUT) >= 0) {
+        if (write_reg(SPLIT_STATS_RGBLIGHT, I2C_RGB_START, (void *)&rgblight_sync, sizeof(rgblight_sync)) >= 0) {
             rgblight_clear_change_flags();
         }
     }
 #    endif
 
-#    ifdef ENCODER_ENABLE
-    i2c_readReg(SLAVE_I2C_ADDRESS, I2C_ENCODER_START, (void *)i2c_buffer->encoder_state, sizeof(i2c_buffer->encoder_state), TIMEOUT);
+#    if defined(ENCODER_ENABLE) && !defined(SPLIT_TRANSPORT_ON_CHANGE)
+    read_reg(SPLIT_STATS_ENCODERS, I2C_ENCODER_START, (void *)i2c_buffer->encoder_state, sizeof(i2c_buffer->encoder_state));
     encoder_update_raw(i2c_buffer->encoder_state);
 #    endif
 
-#    ifdef WPM_ENABLE
-    uint8_t current_wpm = get_current_wpm();
-    if (current_wpm != i2c_buffer->current_wpm) {
-        if (i2c_writeReg(SLAVE_I2C_ADDRESS, I2C_WPM_START, (void *)&current_wpm, sizeof(current_wpm), TIMEOUT) >= 0) {
-            i2c_buffer->current_wpm = current_wpm;
-        }
-    }
-#    endif
+    // after the matrix, which always goes first
+    transport_sync_master();
     return true;
 }
 
 void transport_slave(matrix_row_t matrix[]) {
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    // Copy matrix to I2C buffer, the sequence is incremented after the data it covers
+    bool    changed = false;
+    uint8_t packed[PACKED_MATRIX_SIZE];
+    pack_matrix(packed, matrix);
+    if (memcmp(i2c_buffer->smatrix, packed, sizeof(packed))) {
+        memcpy(i2c_buffer->smatrix, packed, sizeof(packed));
+        changed = true;
+    }
+#        ifdef ENCODER_ENABLE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+    encoder_state_raw(encoder_state);
+    if (memcmp(i2c_buffer->encoder_state, encoder_state, sizeof(encoder_state))) {
+        memcpy(i2c_buffer->encoder_state, encoder_state, sizeof(encoder_state));
+        changed = true;
+    }
+#        endif
+    if (changed) {
+        // the I2C interrupt may read the buffer in between, so keep the stores in order
+        __asm__ volatile("" ::: "memory");
+        (*(volatile uint8_t *)&i2c_buffer->sequence)++;
+    }
+#    else
     // Copy matrix to I2C buffer
-    memcpy((void *)i2c_buffer->smatrix, (void *)matrix, sizeof(i2c_buffer->smatrix));
-
-// Read Backlight Info
-#    ifdef BACKLIGHT_ENABLE
-    backlight_set(i2c_buffer->backlight_level);
+    pack_matrix(i2c_buffer->smatrix, matrix);
 #    endif
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
@@ -111,40 +250,40 @@ void transport_slave(matrix_row_t matrix[]) {
     }
 #    endif
 
-#    ifdef ENCODER_ENABLE
+#    if defined(ENCODER_ENABLE) && !defined(SPLIT_TRANSPORT_ON_CHANGE)
     encoder_state_raw(i2c_buffer->encoder_state);
 #    endif
 
-#    ifdef WPM_ENABLE
-    set_current_wpm(i2c_buffer->current_wpm);
-#    endif
+    transport_sync_slave();
 }
 
-void transport_master_init(void) { i2c_init(); }
+void transport_master_init(void) {
+    transport_sync_init();
+    i2c_init();
+}
 
-void transport_slave_init(void) { i2c_slave_init(SLAVE_I2C_ADDRESS); }
+void transport_slave_init(void) {
+    transport_sync_init();
+    i2c_slave_init(SLAVE_I2C_ADDRESS);
+}
 
 #else  // USE_SERIAL
 
 #    include "serial.h"
 
 typedef struct _Serial_s2m_buffer_t {
-    // TODO: if MATRIX_COLS > 8 change to uint8_t packed_matrix[] for pack/unpack
-    matrix_row_t smatrix[ROWS_PER_HAND];
+    uint8_t smatrix[PACKED_MATRIX_SIZE];
 
 #    ifdef ENCODER_ENABLE
     uint8_t      encoder_state[NUMBER_OF_ENCODERS];
 #    endif
 
+    uint8_t sync_ack;       // the last packet from the master that the slave applied
+    uint8_t sync_sequence;  // the sequence of serial_sync_s2m
 } Serial_s2m_buffer_t;
 
 typedef struct _Serial_m2s_buffer_t {
-#    ifdef BACKLIGHT_ENABLE
-    uint8_t backlight_level;
-#    endif
-#    ifdef WPM_ENABLE
-    uint8_t current_wpm;
-#    endif
+    uint8_t sync_ack;  // the last packet from the slave that the master applied
 } Serial_m2s_buffer_t;
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
@@ -168,14 +307,48 @@ volatile Serial_s2m_buffer_t serial_s2m_buffer = {};
 volatile Serial_m2s_buffer_t serial_m2s_buffer = {};
 uint8_t volatile status0                       = 0;
 
+// The sync packets have transactions of their own, which only run when there is a packet to send
+volatile split_sync_packet_t serial_sync_m2s = {};
+volatile split_sync_packet_t serial_sync_s2m = {};
+uint8_t volatile status_sync_m2s             = 0;
+uint8_t volatile status_sync_s2m             = 0;
+
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+// The master reads the sequence every scan, and serial_s2m_buffer only when the slave has
+// incremented it. The master to slave data goes with the sequence.
+uint8_t volatile serial_s2m_sequence = 0;
+uint8_t volatile status_sequence     = 0;
+#    endif
+
 enum serial_transaction_id {
     GET_SLAVE_MATRIX = 0,
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    GET_SLAVE_SEQUENCE,
+#    endif
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     PUT_RGBLIGHT,
 #    endif
+    PUT_SYNC,
+    GET_SYNC,
 };
 
 SSTD_t transactions[] = {
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    [GET_SLAVE_MATRIX] =
+        {
+            (uint8_t *)&status0, 0, NULL,  // no master to slave transfer
+            sizeof(serial_s2m_buffer),
+            (uint8_t *)&serial_s2m_buffer,
+        },
+    [GET_SLAVE_SEQUENCE] =
+        {
+            (uint8_t *)&status_sequence,
+            sizeof(serial_m2s_buffer),
+            (uint8_t *)&serial_m2s_buffer,
+            sizeof(serial_s2m_sequence),
+            (uint8_t *)&serial_s2m_sequence,
+        },
+#    else
     [GET_SLAVE_MATRIX] =
         {
             (uint8_t *)&status0,
@@ -184,17 +357,57 @@ SSTD_t transactions[] = {
             sizeof(serial_s2m_buffer),
             (uint8_t *)&serial_s2m_buffer,
         },
+#    endif
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
     [PUT_RGBLIGHT] =
         {
             (uint8_t *)&status_rgblight, sizeof(serial_rgblight), (uint8_t *)&serial_rgblight, 0, NULL  // no slave to master transfer
         },
 #    endif
+    [PUT_SYNC] =
+        {
+            (uint8_t *)&status_sync_m2s, sizeof(serial_sync_m2s), (uint8_t *)&serial_sync_m2s, 0, NULL  // no slave to master transfer
+        },
+    [GET_SYNC] =
+        {
+            (uint8_t *)&status_sync_s2m, 0, NULL,  // no master to slave transfer
+            sizeof(serial_sync_s2m),
+            (uint8_t *)&serial_sync_s2m,
+        },
 };
 
-void transport_master_init(void) { soft_serial_initiator_init(transactions, TID_LIMIT(transactions)); }
+#    ifdef SPLIT_TRANSPORT_STATS
+static const uint8_t transaction_stats[] = {
+    [GET_SLAVE_MATRIX] = SPLIT_STATS_MATRIX,
+#        ifdef SPLIT_TRANSPORT_ON_CHANGE
+    [GET_SLAVE_SEQUENCE] = SPLIT_STATS_SEQUENCE,
+#        endif
+#        if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    [PUT_RGBLIGHT] = SPLIT_STATS_RGBLIGHT,
+#        endif
+    [PUT_SYNC] = SPLIT_STATS_SYNC_TO_SLAVE,
+    [GET_SYNC] = SPLIT_STATS_SYNC_TO_MASTER,
+};
 
-void transport_slave_init(void) { soft_serial_target_init(transactions, TID_LIMIT(transactions)); }
+static int master_transaction(uint8_t id) {
+    uint32_t start  = split_stats_begin(transaction_stats[id]);
+    int      result = soft_serial_transaction(id);
+    split_stats_end(transaction_stats[id], start, result == TRANSACTION_END ? SPLIT_STATS_OK : result == TRANSACTION_NO_RESPONSE ? SPLIT_STATS_TIMEOUT : SPLIT_STATS_ERROR);
+    return result;
+}
+#    else
+#        define master_transaction(id) soft_serial_transaction(id)
+#    endif
+
+void transport_master_init(void) {
+    transport_sync_init();
+    soft_serial_initiator_init(transactions, TID_LIMIT(transactions));
+}
+
+void transport_slave_init(void) {
+    transport_sync_init();
+    soft_serial_target_init(transactions, TID_LIMIT(transactions));
+}
 
 #    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
 
@@ -203,7 +416,7 @@ void transport_slave_init(void) { soft_serial_target_init(transactions, TID_LIMI
 void transport_rgblight_master(void) {
     if (rgblight_get_change_flags()) {
         rgblight_get_syncinfo((rgblight_syncinfo_t *)&serial_rgblight.rgblight_sync);
-        if (soft_serial_transaction(PUT_RGBLIGHT) == TRANSACTION_END) {
+        if (master_transaction(PUT_RGBLIGHT) == TRANSACTION_END) {
             rgblight_clear_change_flags();
         }
     }
@@ -221,56 +434,122 @@ void transport_rgblight_slave(void) {
 #        define transport_rgblight_slave()
 #    endif
 
-bool transport_master(matrix_row_t matrix[]) {
-#    ifndef SERIAL_USE_MULTI_TRANSACTION
-    if (soft_serial_transaction() != TRANSACTION_END) {
-        return false;
+static void read_slave_buffer(matrix_row_t matrix[]) {
+    unpack_matrix(matrix, (uint8_t *)serial_s2m_buffer.smatrix);
+
+#    ifdef ENCODER_ENABLE
+    encoder_update_raw((uint8_t *)serial_s2m_buffer.encoder_state);
+#    endif
+}
+
+// The acks and the sequence of the slave's packet go with the matrix
+static void transport_sync_master(void) {
+    transport_sync_update_master();
+    if (split_sync_send(SPLIT_SYNC_TO_SLAVE, &serial_sync_m2s, serial_s2m_buffer.sync_ack)) {
+        master_transaction(PUT_SYNC);
     }
-#    else
-    transport_rgblight_master();
-    if (soft_serial_transaction(GET_SLAVE_MATRIX) != TRANSACTION_END) {
+    if (serial_s2m_buffer.sync_sequence != serial_m2s_buffer.sync_ack && master_transaction(GET_SYNC) == TRANSACTION_END) {
+        serial_m2s_buffer.sync_ack = split_sync_receive(SPLIT_SYNC_TO_MASTER, &serial_sync_s2m);
+    }
+}
+
+// Returns true when the acks or the sequence in serial_s2m_buffer have changed
+static bool transport_sync_slave(void) {
+    uint8_t ack = split_sync_receive(SPLIT_SYNC_TO_SLAVE, &serial_sync_m2s);
+    split_sync_update(SPLIT_SYNC_TO_MASTER);
+    split_sync_send(SPLIT_SYNC_TO_MASTER, &serial_sync_s2m, serial_m2s_buffer.sync_ack);
+
+    uint8_t sequence = serial_sync_s2m.sequence;
+    if (serial_s2m_buffer.sync_ack == ack && serial_s2m_buffer.sync_sequence == sequence) {
         return false;
     }
+    serial_s2m_buffer.sync_ack      = ack;
+    serial_s2m_buffer.sync_sequence = sequence;
+    return true;
+}
+
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+static uint8_t last_sequence;
+static bool    slave_synced = false;
 #    endif
 
-    // TODO:  if MATRIX_COLS > 8 change to unpack()
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        matrix[i] = serial_s2m_buffer.smatrix[i];
+static bool master_transfer(matrix_row_t matrix[]) {
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    transport_rgblight_master();
+    if (master_transaction(GET_SLAVE_SEQUENCE) != TRANSACTION_END) {
+        slave_synced = false;
+        return false;
     }
 
-#    ifdef BACKLIGHT_ENABLE
-    // Write backlight level for slave to read
-    serial_m2s_buffer.backlight_level = is_backlight_enabled() ? get_backlight_level() : 0;
-#    endif
+    // Only read the rows when the slave has changed them since the last read
+    if (!slave_synced || serial_s2m_sequence != last_sequence) {
+        last_sequence = serial_s2m_sequence;
+        slave_synced  = master_transaction(GET_SLAVE_MATRIX) == TRANSACTION_END;
+        if (!slave_synced) {
+            return false;
+        }
+        read_slave_buffer(matrix);
+    }
+#    else
+    transport_rgblight_master();
+    if (master_transaction(GET_SLAVE_MATRIX) != TRANSACTION_END) {
+        return false;
+    }
 
-#    ifdef ENCODER_ENABLE
-    encoder_update_raw((uint8_t *)serial_s2m_buffer.encoder_state);
+    read_slave_buffer(matrix);
 #    endif
 
-#    ifdef WPM_ENABLE
-    // Write wpm to slave
-    serial_m2s_buffer.current_wpm = get_current_wpm();
-#    endif
+    // after the matrix, which always goes first
+    transport_sync_master();
     return true;
 }
 
 void transport_slave(matrix_row_t matrix[]) {
     transport_rgblight_slave();
-    // TODO: if MATRIX_COLS > 8 change to pack()
-    for (int i = 0; i < ROWS_PER_HAND; ++i) {
-        serial_s2m_buffer.smatrix[i] = matrix[i];
+#    ifdef SPLIT_TRANSPORT_ON_CHANGE
+    // The sequence is incremented after the data it covers
+    bool    changed = transport_sync_slave();
+    uint8_t packed[PACKED_MATRIX_SIZE];
+    pack_matrix(packed, matrix);
+    for (int i = 0; i < PACKED_MATRIX_SIZE; ++i) {
+        if (serial_s2m_buffer.smatrix[i] != packed[i]) {
+            serial_s2m_buffer.smatrix[i] = packed[i];
+            changed                      = true;
+        }
     }
-#    ifdef BACKLIGHT_ENABLE
-    backlight_set(serial_m2s_buffer.backlight_level);
-#    endif
+#        ifdef ENCODER_ENABLE
+    uint8_t encoder_state[NUMBER_OF_ENCODERS];
+    encoder_state_raw(encoder_state);
+    for (int i = 0; i < NUMBER_OF_ENCODERS; ++i) {
+        if (serial_s2m_buffer.encoder_state[i] != encoder_state[i]) {
+            serial_s2m_buffer.encoder_state[i] = encoder_state[i];
+            changed                            = true;
+        }
+    }
+#        endif
+    if (changed) {
+        serial_s2m_sequence++;
+    }
+#    else
+    pack_matrix((uint8_t *)serial_s2m_buffer.smatrix, matrix);
 
-#    ifdef ENCODER_ENABLE
+#        ifdef ENCODER_ENABLE
     encoder_state_raw((uint8_t *)serial_s2m_buffer.encoder_state);
-#    endif
+#        endif
 
-#    ifdef WPM_ENABLE
-    set_current_wpm(serial_m2s_buffer.current_wpm);
+    transport_sync_slave();
 #    endif
 }
 
 #endif
+
+bool transport_master(matrix_row_t matrix[]) {
+#ifdef SPLIT_TRANSPORT_STATS
+    uint32_t start = split_stats_begin(SPLIT_STATS_SCAN);
+    bool     ok    = master_transfer(matrix);
+    split_stats_end(SPLIT_STATS_SCAN, start, ok ? SPLIT_STATS_OK : SPLIT_STATS_ERROR);
+    return ok;
+#else
+    return master_transfer(matrix);
+#endif
+}
@@ -0,0 +1,72 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Host stand-in for the pin functions of quantum.h, included ahead of everything else by the
+ * matrix tests (see rules.mk) and backed by the simulated matrix in matrix_pin_mock.cpp.
+ *
+ * A pin is its port times 16 plus its pad, as on AVR. The columns run across ports A, B and C,
+ * with runs broken by a port change (also where the pads continue), a gap, a port used again
+ * and pins in descending order.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint8_t  pin_t;
+typedef uint16_t port_data_t;
+
+#define MOCK_PIN(port, pad) ((pin_t)(((port) << 4) | (pad)))
+#define MOCK_PORT_A 0
+#define MOCK_PORT_B 1
+#define MOCK_PORT_C 2
+#define MOCK_PORT_D 3
+#define MOCK_PORTS 4
+
+#define setPinInputHigh(pin) mock_set_pin_input_high(pin)
+#define setPinOutput(pin) mock_set_pin_output(pin)
+#define writePinHigh(pin) mock_write_pin(pin, true)
+#define writePinLow(pin) mock_write_pin(pin, false)
+#define readPin(pin) mock_read_pin(pin)
+
+#define getPinPort(pin) ((pin) >> 4)
+#define getPinPad(pin) ((pin)&0xF)
+#define readPort(pin) mock_read_port(getPinPort(pin))
+
+// clang-format off
+#define MATRIX_ROW_PINS { MOCK_PIN(MOCK_PORT_D, 0), MOCK_PIN(MOCK_PORT_D, 1), MOCK_PIN(MOCK_PORT_D, 2), MOCK_PIN(MOCK_PORT_D, 3) }
+#define MATRIX_COL_PINS { \
+    MOCK_PIN(MOCK_PORT_A, 14), MOCK_PIN(MOCK_PORT_A, 15), \
+    MOCK_PIN(MOCK_PORT_B, 0), MOCK_PIN(MOCK_PORT_B, 1), MOCK_PIN(MOCK_PORT_B, 2), \
+    MOCK_PIN(MOCK_PORT_B, 5), \
+    MOCK_PIN(MOCK_PORT_A, 6), \
+    MOCK_PIN(MOCK_PORT_C, 7), MOCK_PIN(MOCK_PORT_C, 6), \
+    MOCK_PIN(MOCK_PORT_C, 8), MOCK_PIN(MOCK_PORT_C, 9), \
+    MOCK_PIN(MOCK_PORT_A, 4) }
+// clang-format on
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void        mock_set_pin_input_high(pin_t pin);
+void        mock_set_pin_output(pin_t pin);
+void        mock_write_pin(pin_t pin, bool level);
+bool        mock_read_pin(pin_t pin);
+port_data_t mock_read_port(uint8_t port);
+#ifdef __cplusplus
+}
+#endif
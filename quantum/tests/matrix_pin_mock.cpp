@@ -0,0 +1,91 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "matrix_pin_mock.h"
+
+static const pin_t row_pins[MATRIX_ROWS] = MATRIX_ROW_PINS;
+static const pin_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
+
+MatrixPinMock *MatrixPinMock::instance = nullptr;
+
+MatrixPinMock::MatrixPinMock() {
+    for (bool &d : driven) {
+        d = true;
+    }
+}
+
+bool MatrixPinMock::level(pin_t pin) const {
+    if (output[pin]) {
+        return driven[pin];
+    }
+    if (held_low[pin]) {
+        return false;
+    }
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        if (col_pins[col] != pin) {
+            continue;
+        }
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            if (keys[row][col] && output[row_pins[row]] && !driven[row_pins[row]]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void MatrixPinMock::set_input_high(pin_t pin) { output[pin] = false; }
+
+void MatrixPinMock::set_output(pin_t pin) { output[pin] = true; }
+
+void MatrixPinMock::write(pin_t pin, bool level) {
+    if (!output[pin]) {
+        errors++;
+    }
+    driven[pin] = level;
+}
+
+bool MatrixPinMock::read_pin(pin_t pin) {
+    pin_reads++;
+    return level(pin);
+}
+
+port_data_t MatrixPinMock::read_port(uint8_t port) {
+    if (port >= MOCK_PORTS) {
+        errors++;
+        return 0xFFFF;
+    }
+    port_reads++;
+    port_data_t value = 0;
+    for (uint8_t pad = 0; pad < 16; pad++) {
+        value |= (port_data_t)level(MOCK_PIN(port, pad)) << pad;
+    }
+    return value;
+}
+
+extern "C" {
+void mock_set_pin_input_high(pin_t pin) { MatrixPinMock::instance->set_input_high(pin); }
+
+void mock_set_pin_output(pin_t pin) { MatrixPinMock::instance->set_output(pin); }
+
+void mock_write_pin(pin_t pin, bool level) { MatrixPinMock::instance->write(pin, level); }
+
+bool mock_read_pin(pin_t pin) { return MatrixPinMock::instance->read_pin(pin); }
+
+port_data_t mock_read_port(uint8_t port) { return MatrixPinMock::instance->read_port(port); }
+
+void matrix_io_delay(void) {}
+}
@@ -0,0 +1,57 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+extern "C" {
+#include "matrix.h"
+}
+
+/* Simulates a COL2ROW key matrix wired to the pins of gpio_mock.h. A column reads low
+ * when a pressed key connects it to a row that is driven low. Other inputs are pulled up,
+ * unless held low to check they are ignored.
+ */
+class MatrixPinMock {
+   public:
+    MatrixPinMock();
+
+    void press(uint8_t row, uint8_t col) { keys[row][col] = true; }
+    void release(uint8_t row, uint8_t col) { keys[row][col] = false; }
+    void hold_low(pin_t pin) { held_low[pin] = true; }
+
+    uint32_t pin_reads  = 0;
+    uint32_t port_reads = 0;
+    uint32_t errors     = 0;
+
+    // how the matrix code drives the pins
+    void        set_input_high(pin_t pin);
+    void        set_output(pin_t pin);
+    void        write(pin_t pin, bool level);
+    bool        read_pin(pin_t pin);
+    port_data_t read_port(uint8_t port);
+
+    static MatrixPinMock *instance;
+
+   private:
+    bool level(pin_t pin) const;
+
+    bool keys[MATRIX_ROWS][MATRIX_COLS] = {};
+    bool output[256]                    = {};
+    bool driven[256]                    = {};
+    bool held_low[256]                  = {};
+};
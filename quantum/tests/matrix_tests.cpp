@@ -0,0 +1,158 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Built with MATRIX_PARALLEL_COL_READ, MATRIX_FAST_IDLE_SCAN and both, see rules.mk. */
+
+#include "gtest/gtest.h"
+#include "matrix_pin_mock.h"
+
+extern "C" {
+#include "debounce.h"
+
+matrix_row_t raw_matrix[MATRIX_ROWS];
+matrix_row_t matrix[MATRIX_ROWS];
+
+void debounce_init(uint8_t num_rows) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        cooked[row] = raw[row];
+    }
+}
+
+void matrix_init_quantum(void) {}
+
+void matrix_scan_quantum(void) {}
+}
+
+#define ALL_COLS ((matrix_row_t)((1 << MATRIX_COLS) - 1))
+#define COL_PORTS 3
+
+class Matrix : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MatrixPinMock::instance = &pins;
+        matrix_init();
+        matrix_scan();
+        pins.pin_reads  = 0;
+        pins.port_reads = 0;
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(pins.errors, 0);
+        MatrixPinMock::instance = nullptr;
+    }
+
+    MatrixPinMock pins;
+};
+
+TEST_F(Matrix, NoKeys) {
+    EXPECT_FALSE(matrix_scan());
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        EXPECT_EQ(raw_matrix[row], 0);
+    }
+}
+
+TEST_F(Matrix, EveryColumnIsReportedInPlace) {
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        uint8_t row = col % MATRIX_ROWS;
+        pins.press(row, col);
+        EXPECT_TRUE(matrix_scan());
+        for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+            EXPECT_EQ(raw_matrix[r], r == row ? (matrix_row_t)(1 << col) : 0) << "col " << (int)col;
+        }
+        pins.release(row, col);
+        EXPECT_TRUE(matrix_scan());
+        EXPECT_EQ(raw_matrix[row], 0);
+    }
+}
+
+TEST_F(Matrix, AllKeys) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            pins.press(row, col);
+        }
+    }
+    EXPECT_TRUE(matrix_scan());
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        EXPECT_EQ(raw_matrix[row], ALL_COLS);
+    }
+    EXPECT_FALSE(matrix_scan());
+}
+
+TEST_F(Matrix, OtherPinsOfTheColumnPortsAreIgnored) {
+    pins.hold_low(MOCK_PIN(MOCK_PORT_A, 0));
+    pins.hold_low(MOCK_PIN(MOCK_PORT_A, 13));
+    pins.hold_low(MOCK_PIN(MOCK_PORT_B, 3));
+    pins.hold_low(MOCK_PIN(MOCK_PORT_C, 15));
+    pins.press(2, 5);
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(raw_matrix[0], 0);
+    EXPECT_EQ(raw_matrix[2], 1 << 5);
+}
+
+#ifdef MATRIX_PARALLEL_COL_READ
+TEST_F(Matrix, EveryPortIsReadOncePerRow) {
+    pins.press(0, 0);
+    matrix_scan();
+    pins.port_reads = 0;
+    matrix_scan();
+    EXPECT_EQ(pins.port_reads, MATRIX_ROWS * COL_PORTS);
+    EXPECT_EQ(pins.pin_reads, 0);
+}
+#endif
+
+#ifdef MATRIX_FAST_IDLE_SCAN
+TEST_F(Matrix, IdleScanReadsTheColumnsOnce) {
+    EXPECT_FALSE(matrix_scan());
+#    ifdef MATRIX_PARALLEL_COL_READ
+    EXPECT_EQ(pins.port_reads, COL_PORTS);
+#    else
+    EXPECT_EQ(pins.pin_reads, MATRIX_COLS);
+#    endif
+}
+
+TEST_F(Matrix, KeyIsFoundByTheIdleScan) {
+    pins.press(MATRIX_ROWS - 1, MATRIX_COLS - 1);
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(raw_matrix[MATRIX_ROWS - 1], 1 << (MATRIX_COLS - 1));
+
+    // full scans while the key is down, and once more after it is released
+    pins.release(MATRIX_ROWS - 1, MATRIX_COLS - 1);
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(raw_matrix[MATRIX_ROWS - 1], 0);
+
+    pins.pin_reads  = 0;
+    pins.port_reads = 0;
+    EXPECT_FALSE(matrix_scan());
+#    ifdef MATRIX_PARALLEL_COL_READ
+    EXPECT_EQ(pins.port_reads, COL_PORTS);
+#    else
+    EXPECT_EQ(pins.pin_reads, MATRIX_COLS);
+#    endif
+}
+
+TEST_F(Matrix, IdleScanIgnoresOtherPinsOfTheColumnPorts) {
+    pins.hold_low(MOCK_PIN(MOCK_PORT_A, 0));
+    pins.hold_low(MOCK_PIN(MOCK_PORT_C, 15));
+    EXPECT_FALSE(matrix_scan());
+#    ifdef MATRIX_PARALLEL_COL_READ
+    EXPECT_EQ(pins.port_reads, COL_PORTS);
+#    else
+    EXPECT_EQ(pins.pin_reads, MATRIX_COLS);
+#    endif
+}
+#endif
@@ -0,0 +1,23 @@
+MATRIX_COMMON_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=12 -DDIODE_DIRECTION=COL2ROW -DNO_PRINT
+
+MATRIX_COMMON_SRC :=\
+	$(QUANTUM_PATH)/tests/matrix_tests.cpp \
+	$(QUANTUM_PATH)/tests/matrix_pin_mock.cpp \
+	$(QUANTUM_PATH)/matrix.c
+
+MATRIX_COMMON_INC := $(QUANTUM_PATH)/tests $(QUANTUM_PATH)
+
+matrix_parallel_col_read_DEFS := $(MATRIX_COMMON_DEFS) -DMATRIX_PARALLEL_COL_READ
+matrix_parallel_col_read_SRC := $(MATRIX_COMMON_SRC)
+matrix_parallel_col_read_INC := $(MATRIX_COMMON_INC)
+matrix_parallel_col_read_CONFIG := $(QUANTUM_PATH)/tests/gpio_mock.h
+
+matrix_fast_idle_scan_DEFS := $(MATRIX_COMMON_DEFS) -DMATRIX_FAST_IDLE_SCAN
+matrix_fast_idle_scan_SRC := $(MATRIX_COMMON_SRC)
+matrix_fast_idle_scan_INC := $(MATRIX_COMMON_INC)
+matrix_fast_idle_scan_CONFIG := $(QUANTUM_PATH)/tests/gpio_mock.h
+
+matrix_fast_idle_parallel_DEFS := $(MATRIX_COMMON_DEFS) -DMATRIX_FAST_IDLE_SCAN -DMATRIX_PARALLEL_COL_READ
+matrix_fast_idle_parallel_SRC := $(MATRIX_COMMON_SRC)
+matrix_fast_idle_parallel_INC := $(MATRIX_COMMON_INC)
+matrix_fast_idle_parallel_CONFIG := $(QUANTUM_PATH)/tests/gpio_mock.h
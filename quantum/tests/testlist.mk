@@ -0,0 +1,4 @@
+TEST_LIST +=\
+	matrix_parallel_col_read\
+	matrix_fast_idle_scan\
+	matrix_fast_idle_parallel
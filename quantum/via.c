@@ -46,6 +46,12 @@
 #include "dynamic_keymap.h"
 #include "tmk_core/common/eeprom.h"
 #include "version.h"  // for QMK_BUILDDATE used in EEPROM magic
+#ifdef PERF_STATS_ENABLE
+#    include "perf_stats.h"
+#endif
+#ifdef SPLIT_TRANSPORT_STATS
+#    include "split_stats.h"
+#endif
 
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
@@ -383,6 +389,18 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             bootloader_jump();
             break;
         }
+#ifdef PERF_STATS_ENABLE
+        case PERF_STATS_RAW_HID_ID: {
+            perf_stats_raw_hid_receive(data, length);
+            break;
+        }
+#endif
+#ifdef SPLIT_TRANSPORT_STATS
+        case SPLIT_STATS_RAW_HID_ID: {
+            split_stats_raw_hid_receive(data, length);
+            break;
+        }
+#endif
         default: {
             // The command ID is not known
             // Return the unhandled state
@@ -0,0 +1,85 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+
+extern "C" {
+#include "action_layer.h"
+#include "keycode_config.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class ActionLookup : public TestFixture {};
+
+TEST_F(ActionLookup, CachedActionMatchesActionForKey) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (layer_state_t state = 0; state < (1 << 3); state++) {
+        layer_state_set(state);
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keypos_t key = {.col = col, .row = row};
+                EXPECT_EQ(layer_switch_get_action(key).code, action_for_key(layer_switch_get_layer(key), key).code);
+            }
+        }
+    }
+}
+
+TEST_F(ActionLookup, CachedActionFollowsKeymapConfig) {
+    keypos_t caps = {.col = 5, .row = 0};
+
+    EXPECT_EQ(layer_switch_get_action(caps).code, ACTION_KEY(KC_CAPS));
+    keymap_config.capslock_to_control = true;
+    EXPECT_EQ(layer_switch_get_action(caps).code, ACTION_KEY(KC_LCTL));
+    keymap_config.capslock_to_control = false;
+    EXPECT_EQ(layer_switch_get_action(caps).code, ACTION_KEY(KC_CAPS));
+}
+
+// Not a pass/fail test, prints the per lookup cost of both paths on the host
+TEST_F(ActionLookup, Benchmark) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    const unsigned iterations = 100000;
+    volatile uint16_t sink = 0;
+
+    layer_state_set((1 << 1) | (1 << 2));
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        keypos_t key = {.col = (uint8_t)(i % MATRIX_COLS), .row = (uint8_t)((i / MATRIX_COLS) % MATRIX_ROWS)};
+        for (int8_t layer = 2; layer >= 0; layer--) {
+            action_t action = action_for_key(layer, key);
+            sink = action.code;
+            if (action.code != ACTION_TRANSPARENT) break;
+        }
+    }
+    auto uncached = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        keypos_t key = {.col = (uint8_t)(i % MATRIX_COLS), .row = (uint8_t)((i / MATRIX_COLS) % MATRIX_ROWS)};
+        sink = layer_switch_get_action(key).code;
+    }
+    auto cached = std::chrono::steady_clock::now() - start;
+    (void)sink;
+
+    std::cout << "action lookup, layer walk: " << std::chrono::duration<double, std::nano>(uncached).count() / iterations << " ns" << std::endl;
+    std::cout << "action lookup, cached:     " << std::chrono::duration<double, std::nano>(cached).count() / iterations << " ns" << std::endl;
+}
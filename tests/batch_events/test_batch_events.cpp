@@ -0,0 +1,94 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class BatchEvents : public TestFixture {};
+
+TEST_F(BatchEvents, KeysChangedInOneScanAreSentInOneReport) {
+    TestDriver driver;
+    InSequence s;
+    press_key(1, 0);
+    press_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B, KC_C)));
+    run_one_scan_loop();
+    release_key(1, 0);
+    release_key(0, 3);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(BatchEvents, ModifierAndKeyInOneScanAreSentTogether) {
+    TestDriver driver;
+    InSequence s;
+    press_key(3, 0);
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_LSFT)));
+    run_one_scan_loop();
+    release_key(3, 0);
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(BatchEvents, TapIsNotCoalescedAway) {
+    TestDriver driver;
+    InSequence s;
+    press_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    run_one_scan_loop();
+    release_key(7, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_P)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(BatchEvents, ChangesBeyondTheQueueSizeAreSentOnTheNextScan) {
+    TestDriver driver;
+    InSequence s;
+    for (uint8_t col = 0; col < 6; col++) {
+        press_key(col, 1);
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_F, KC_G, KC_H)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_E, KC_F, KC_G, KC_H, KC_I, KC_J)));
+    run_one_scan_loop();
+    for (uint8_t col = 0; col < 6; col++) {
+        release_key(col, 1);
+    }
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_I, KC_J)));
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(BatchEvents, OtherReportsAreSentAfterTheQueuedKeyboardReport) {
+    TestDriver driver;
+    InSequence s;
+    press_key(0, 0);
+    press_key(0, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_consumer_mock(AUDIO_VOL_UP));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(0, 2);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_consumer_mock(0));
+    run_one_scan_loop();
+}
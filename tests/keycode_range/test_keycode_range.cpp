@@ -0,0 +1,101 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+static uint16_t magic_calls;
+static uint16_t magic_last_keycode;
+
+extern "C" bool process_magic(uint16_t keycode, keyrecord_t *record) {
+    magic_calls++;
+    magic_last_keycode = keycode;
+    return true;
+}
+
+class KeycodeRange : public TestFixture {
+   public:
+    KeycodeRange() {
+        magic_calls        = 0;
+        magic_last_keycode = KC_NO;
+    }
+};
+
+TEST_F(KeycodeRange, ProcessorIsNotCalledForKeycodesOutsideItsRange) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);  // KC_A
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EQ(magic_calls, 0);
+}
+
+TEST_F(KeycodeRange, ProcessorIsCalledForBothEndsOfItsRange) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+
+    press_key(4, 0);  // MAGIC_SWAP_CONTROL_CAPSLOCK
+    run_one_scan_loop();
+    EXPECT_EQ(magic_calls, 1);
+    EXPECT_EQ(magic_last_keycode, MAGIC_SWAP_CONTROL_CAPSLOCK);
+    release_key(4, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(magic_calls, 2);
+
+    press_key(5, 0);  // MAGIC_EE_HANDS_RIGHT
+    run_one_scan_loop();
+    EXPECT_EQ(magic_calls, 3);
+    EXPECT_EQ(magic_last_keycode, MAGIC_EE_HANDS_RIGHT);
+    release_key(5, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(magic_calls, 4);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeycodeRange, GraveEscapeIsReportedAsEscapeOrGrave) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(2, 0);  // KC_GESC
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ESC)));
+    run_one_scan_loop();
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    press_key(1, 0);  // KC_LSFT
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    press_key(2, 0);  // KC_GESC
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_GRV)));
+    run_one_scan_loop();
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
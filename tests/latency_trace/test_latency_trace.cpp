@@ -0,0 +1,94 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+extern "C" {
+#include "latency_trace.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class LatencyTrace : public TestFixture {
+   public:
+    void SetUp() override { latency_trace_clear(); }
+};
+
+TEST_F(LatencyTrace, PlainKeysAreReportedInTheSameScan) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    const latency_stats_t *stats = latency_trace_stats();
+    EXPECT_EQ(stats->count, 2);
+    EXPECT_EQ(stats->max_us, 0);
+    EXPECT_EQ(stats->histogram[0], 2);
+
+    const latency_sample_t *latest = latency_trace_sample(0);
+    ASSERT_NE(latest, nullptr);
+    EXPECT_FALSE(latest->pressed);
+    EXPECT_TRUE(latency_trace_sample(1)->pressed);
+    EXPECT_EQ(latency_trace_sample(2), nullptr);
+}
+
+TEST_F(LatencyTrace, TapIsDelayedUntilRelease) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(50);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    // the press is only reported once the release is seen
+    EXPECT_EQ(latency_trace_stats()->count, 2);
+    const latency_sample_t *tap = latency_trace_sample(1);
+    EXPECT_TRUE(tap->pressed);
+    EXPECT_EQ(tap->key.col, 1);
+    EXPECT_EQ(tap->latency_us, 50 * 1000);
+    EXPECT_FALSE(latency_trace_sample(0)->pressed);
+    EXPECT_EQ(latency_trace_sample(0)->latency_us, 0);
+}
+
+TEST_F(LatencyTrace, HoldIsDelayedByTheTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    EXPECT_EQ(latency_trace_stats()->count, 2);
+    EXPECT_EQ(latency_trace_sample(1)->latency_us, (TAPPING_TERM - 1) * 1000);
+    EXPECT_EQ(latency_trace_sample(0)->latency_us, 0);
+    EXPECT_EQ(latency_trace_stats()->max_us, (TAPPING_TERM - 1) * 1000);
+}
@@ -0,0 +1,86 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+extern "C" {
+#include "latency_trace.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class LatencyTraceBatch : public TestFixture {
+   public:
+    void SetUp() override { latency_trace_clear(); }
+};
+
+TEST_F(LatencyTraceBatch, QueuedReportIsRecordedWhenSent) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    ASSERT_EQ(latency_trace_stats()->count, 2);
+    EXPECT_TRUE(latency_trace_sample(1)->pressed);
+    EXPECT_FALSE(latency_trace_sample(0)->pressed);
+}
+
+TEST_F(LatencyTraceBatch, CoalescedReportIsRecordedOnce) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    press_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_C)));
+    run_one_scan_loop();
+
+    ASSERT_EQ(latency_trace_stats()->count, 1);
+    EXPECT_EQ(latency_trace_sample(0)->latency_us, 0);
+
+    release_key(0, 0);
+    release_key(2, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+TEST_F(LatencyTraceBatch, FlushedReportKeepsItsOwnEvent) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(50);
+    release_key(1, 0);
+    // the tap is sent before its release is queued, the release is sent at the end of the scan
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+
+    ASSERT_EQ(latency_trace_stats()->count, 2);
+    const latency_sample_t *tap = latency_trace_sample(1);
+    EXPECT_TRUE(tap->pressed);
+    EXPECT_EQ(tap->key.col, 1);
+    EXPECT_EQ(tap->latency_us, 50 * 1000);
+    EXPECT_FALSE(latency_trace_sample(0)->pressed);
+    EXPECT_EQ(latency_trace_sample(0)->latency_us, 0);
+}
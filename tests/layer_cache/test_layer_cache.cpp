@@ -0,0 +1,87 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "action_layer.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+class LayerCache : public TestFixture {};
+
+TEST_F(LayerCache, ResolvedLayerFollowsLayerChanges) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    keypos_t a = {.col = 0, .row = 0};
+    keypos_t b = {.col = 1, .row = 0};
+
+    EXPECT_EQ(layer_switch_get_layer(a), 0);
+    EXPECT_EQ(layer_switch_get_layer(b), 0);
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(a), 1);
+    EXPECT_EQ(layer_switch_get_layer(b), 0);
+    layer_on(2);
+    EXPECT_EQ(layer_switch_get_layer(a), 1);
+    EXPECT_EQ(layer_switch_get_layer(b), 2);
+    layer_off(1);
+    EXPECT_EQ(layer_switch_get_layer(a), 0);
+    EXPECT_EQ(layer_switch_get_layer(b), 2);
+    layer_clear();
+    EXPECT_EQ(layer_switch_get_layer(a), 0);
+    EXPECT_EQ(layer_switch_get_layer(b), 0);
+}
+
+TEST_F(LayerCache, LayerDirectlyAssignedIsPickedUp) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    keypos_t a = {.col = 0, .row = 0};
+
+    EXPECT_EQ(layer_switch_get_layer(a), 0);
+    layer_state = 1UL << 1;
+    EXPECT_EQ(layer_switch_get_layer(a), 1);
+    layer_state = 0;
+    EXPECT_EQ(layer_switch_get_layer(a), 0);
+}
+
+TEST_F(LayerCache, MomentaryLayerKeysReportTheRightKeys) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(4, 0);
+    // changing layers sends the (unchanged) report
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2)));
+    run_one_scan_loop();
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2, KC_A)));
+    run_one_scan_loop();
+    release_key(4, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2, KC_A)));
+    run_one_scan_loop();
+    // keys pressed on layer 2 are released from the layer they were pressed on
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
@@ -0,0 +1,114 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "perf_stats.h"
+#include "host.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class PerfStats : public TestFixture {
+   public:
+    void SetUp() override { perf_stats_clear(); }
+};
+
+TEST_F(PerfStats, RecordsMinAvgMax) {
+    perf_stats_record(PERF_STATS_USER, 10);
+    perf_stats_record(PERF_STATS_USER, 30);
+    perf_stats_record(PERF_STATS_USER, 20);
+    const perf_stats_t *s = perf_stats_get(PERF_STATS_USER);
+    EXPECT_EQ(s->count, 3);
+    EXPECT_EQ(s->min_us, 10);
+    EXPECT_EQ(s->max_us, 30);
+    EXPECT_EQ(s->total_us / s->count, 20);
+}
+
+TEST_F(PerfStats, HistogramBucketsArePowersOfTwo) {
+    perf_stats_record(PERF_STATS_USER, 0);
+    perf_stats_record(PERF_STATS_USER, 1);
+    perf_stats_record(PERF_STATS_USER, 2);
+    perf_stats_record(PERF_STATS_USER, 3);
+    perf_stats_record(PERF_STATS_USER, 4);
+    perf_stats_record(PERF_STATS_USER, 1000000);
+    const perf_stats_t *s = perf_stats_get(PERF_STATS_USER);
+    EXPECT_EQ(s->histogram[0], 1);
+    EXPECT_EQ(s->histogram[1], 1);
+    EXPECT_EQ(s->histogram[2], 2);
+    EXPECT_EQ(s->histogram[3], 1);
+    EXPECT_EQ(s->histogram[PERF_STATS_BUCKETS - 1], 1);
+    EXPECT_EQ(s->max_us, UINT16_MAX);
+}
+
+TEST_F(PerfStats, KeyboardTaskIsInstrumented) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(9);
+
+    EXPECT_EQ(perf_stats_get(PERF_STATS_SCAN_LOOP)->count, 10);
+    EXPECT_EQ(perf_stats_get(PERF_STATS_MATRIX_SCAN)->count, 10);
+    EXPECT_EQ(perf_stats_get(PERF_STATS_TASKS)->count, 10);
+    EXPECT_EQ(perf_stats_get(PERF_STATS_ACTION_EXEC)->count, 2);
+    EXPECT_EQ(perf_stats_get(PERF_STATS_SEND_REPORT)->count, 2);
+    EXPECT_EQ(perf_stats_scan_rate(), 1000);
+}
+
+TEST_F(PerfStats, OtherReportsAreInstrumented) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_mouse_mock(_));
+    EXPECT_CALL(driver, send_system_mock(_)).Times(2);
+    EXPECT_CALL(driver, send_consumer_mock(_)).Times(2);
+
+    report_mouse_t mouse = {0};
+    host_mouse_send(&mouse);
+    host_system_send(1);
+    host_system_send(0);
+    host_consumer_send(1);
+    host_consumer_send(0);
+
+    EXPECT_EQ(perf_stats_get(PERF_STATS_SEND_REPORT)->count, 5);
+}
+
+TEST_F(PerfStats, RawHidReturnsProbeStatistics) {
+    perf_stats_record(PERF_STATS_USER, 300);
+    perf_stats_record(PERF_STATS_USER, 500);
+
+    uint8_t data[32] = {PERF_STATS_RAW_HID_ID, PERF_STATS_USER};
+    EXPECT_TRUE(perf_stats_raw_hid_receive(data, sizeof(data)));
+    EXPECT_EQ(data[1], PERF_STATS_USER);
+    EXPECT_EQ((data[2] << 24) | (data[3] << 16) | (data[4] << 8) | data[5], 2);
+    EXPECT_EQ((data[6] << 8) | data[7], 300);
+    EXPECT_EQ((data[8] << 8) | data[9], 400);
+    EXPECT_EQ((data[10] << 8) | data[11], 500);
+    // 256-511us
+    EXPECT_EQ((data[12 + 2 * 9] << 8) | data[13 + 2 * 9], 2);
+
+    uint8_t unknown[32] = {PERF_STATS_RAW_HID_ID, PERF_STATS_PROBES};
+    EXPECT_TRUE(perf_stats_raw_hid_receive(unknown, sizeof(unknown)));
+    EXPECT_EQ(unknown[1], 0xFE);
+
+    uint8_t other[32] = {0x01};
+    EXPECT_FALSE(perf_stats_raw_hid_receive(other, sizeof(other)));
+}
@@ -0,0 +1,240 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Replays a recorded key trace through the keymap of one of the tests.
+ *
+ * The trace is read from a file or stdin, one key event per line, either as
+ *     <time in ms> <row> <col> <d|u>
+ * or as the "EVENT: 0102d(1234)" lines printed by the firmware with DEBUG_ACTION, so a
+ * session can be recorded with hid_listen. Everything else (and anything after #) is ignored.
+ *
+ * Every keyboard report is written to stdout, prefixed with the simulated time, so the
+ * output of two firmware versions can be diffed. The number of events, reports and scans,
+ * the host CPU time and the key to report latency are written to stderr.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "quantum.h"
+#include "host.h"
+#include "test_matrix.h"
+#include "latency_trace.h"
+
+void advance_time_us(uint32_t us);
+bool get_next_deadline(uint32_t *us);
+void clear_deadline(void);
+
+typedef struct {
+    uint64_t time_us;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed;
+} trace_event_t;
+
+static uint64_t now_us        = 0;
+static uint32_t scan_interval = 1000;
+static bool     fast_forward  = false;
+static bool     quiet         = false;
+static uint32_t reports       = 0;
+static uint32_t scans         = 0;
+
+static uint8_t keyboard_leds(void) { return 0; }
+
+static void send_keyboard(report_keyboard_t *report) {
+    reports++;
+    if (quiet) {
+        return;
+    }
+    printf("%llu.%03llu", (unsigned long long)(now_us / 1000), (unsigned long long)(now_us % 1000));
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_SIZE; i++) {
+        printf(" %02X", report->raw[i]);
+    }
+    printf("\n");
+}
+
+static void send_mouse(report_mouse_t *report) {}
+static void send_system(uint16_t data) {}
+static void send_consumer(uint16_t data) {}
+
+static host_driver_t replay_driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
+
+/* scan until the simulated time reaches end */
+static void run_until(uint64_t end) {
+    while (now_us < end) {
+        clear_deadline();
+        keyboard_task();
+        scans++;
+
+        uint64_t next = now_us + scan_interval;
+        if (fast_forward) {
+            uint32_t deadline;
+            uint64_t until = get_next_deadline(&deadline) ? now_us + deadline : end;
+            if (until > next) {
+                next = until;
+            }
+        }
+        if (next > end) {
+            next = end;
+        }
+        advance_time_us(next - now_us);
+        now_us = next;
+    }
+}
+
+static bool parse_event(const char *line, trace_event_t *event, uint64_t *debug_time) {
+    const char *debug_event = strstr(line, "EVENT: ");
+    unsigned    key, time, row, col;
+    char        state;
+
+    if (debug_event && sscanf(debug_event, "EVENT: %4x%c(%u)", &key, &state, &time) == 3) {
+        // the firmware only prints the low 16 bits of the time
+        uint16_t delta = time - (*debug_time & 0xFFFF);
+        *debug_time += delta;
+        event->time_us = *debug_time * 1000;
+        event->row     = key >> 8;
+        event->col     = key & 0xFF;
+    } else if (line[0] != '#' && sscanf(line, "%u %u %u %c", &time, &row, &col, &state) == 4) {
+        event->time_us = (uint64_t)time * 1000;
+        event->row     = row;
+        event->col     = col;
+    } else {
+        return false;
+    }
+    event->pressed = state == 'd';
+    return state == 'd' || state == 'u';
+}
+
+static trace_event_t *read_trace(FILE *file, size_t *count) {
+    trace_event_t *events     = NULL;
+    size_t         size       = 0;
+    uint64_t       debug_time = 0;
+    char           line[256];
+
+    *count = 0;
+    while (fgets(line, sizeof(line), file)) {
+        trace_event_t event;
+        if (!parse_event(line, &event, &debug_time)) {
+            continue;
+        }
+        if (event.row >= MATRIX_ROWS || event.col >= MATRIX_COLS) {
+            fprintf(stderr, "ignoring key %u,%u outside of the matrix\n", event.row, event.col);
+            continue;
+        }
+        if (*count == size) {
+            size                 = size ? size * 2 : 256;
+            trace_event_t *grown = realloc(events, size * sizeof(trace_event_t));
+            if (!grown) {
+                fprintf(stderr, "out of memory after %zu events\n", *count);
+                exit(2);
+            }
+            events = grown;
+        }
+        events[(*count)++] = event;
+    }
+    return events;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-s scan interval in us] [-f] [-q] [-l max latency in us] [trace]\n"
+            "  -f  fast forward between deadlines instead of scanning continuously\n"
+            "  -q  don't print the keyboard reports\n"
+            "  -l  fail if any key to report latency is above the limit\n",
+            name);
+}
+
+int main(int argc, char **argv) {
+    uint32_t max_latency = 0;
+    int      opt;
+
+    while ((opt = getopt(argc, argv, "s:fql:h")) != -1) {
+        switch (opt) {
+            case 's':
+                scan_interval = strtoul(optarg, NULL, 10);
+                break;
+            case 'f':
+                fast_forward = true;
+                break;
+            case 'q':
+                quiet = true;
+                break;
+            case 'l':
+                max_latency = strtoul(optarg, NULL, 10);
+                break;
+            default:
+                usage(argv[0]);
+                return 2;
+        }
+    }
+    if (!scan_interval) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE *file = stdin;
+    if (optind < argc && !(file = fopen(argv[optind], "r"))) {
+        perror(argv[optind]);
+        return 2;
+    }
+    size_t         count;
+    trace_event_t *events = read_trace(file, &count);
+    if (file != stdin) {
+        fclose(file);
+    }
+
+    host_set_driver(&replay_driver);
+    keyboard_init();
+
+    // start the trace a scan in, and give the last event time to settle
+    uint64_t offset = count ? events[0].time_us - scan_interval : 0;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (size_t i = 0; i < count; i++) {
+        run_until(events[i].time_us - offset);
+        if (events[i].pressed) {
+            press_key(events[i].col, events[i].row);
+        } else {
+            release_key(events[i].col, events[i].row);
+        }
+    }
+    run_until(now_us + 1000000);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    fflush(stdout);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    fprintf(stderr, "events: %zu, reports: %u, scans: %u, simulated: %llu ms\n", count, reports, scans, (unsigned long long)(now_us / 1000));
+    fprintf(stderr, "host time: %.3f ms, %.0f events/s, %.0f scans/s\n", seconds * 1000, count / seconds, scans / seconds);
+
+    const latency_stats_t *latency = latency_trace_stats();
+    if (latency->count) {
+        fprintf(stderr, "latency: n %u min %u avg %u max %u us |", latency->count, latency->min_us, latency->total_us / latency->count, latency->max_us);
+        for (uint8_t b = 0; b < LATENCY_TRACE_BUCKETS; b++) {
+            fprintf(stderr, " %u", latency->histogram[b]);
+        }
+        fprintf(stderr, "\n");
+    }
+
+    free(events);
+    if (max_latency && latency->max_us > max_latency) {
+        fprintf(stderr, "latency above %u us\n", max_latency);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <chrono>
+#include <iostream>
+
+extern "C" {
+#include "action_layer.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class SourceLayersCache : public TestFixture {};
+
+TEST_F(SourceLayersCache, EveryKeyKeepsItsOwnLayer) {
+    for (uint8_t layer = 0; layer < MAX_LAYER; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                update_source_layers_cache((keypos_t){.col = col, .row = row}, (layer + row + col) % MAX_LAYER);
+            }
+        }
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                EXPECT_EQ(read_source_layers_cache((keypos_t){.col = col, .row = row}), (layer + row + col) % MAX_LAYER);
+            }
+        }
+    }
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            update_source_layers_cache((keypos_t){.col = col, .row = row}, 0);
+        }
+    }
+}
+
+TEST_F(SourceLayersCache, KeyIsReleasedFromTheLayerItWasPressedOn) {
+    TestDriver driver;
+    InSequence s;
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    press_key(20, 7);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2)));
+    run_one_scan_loop();
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_2)));
+    run_one_scan_loop();
+    release_key(20, 7);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
+
+// Not a pass/fail test, prints the cost of one press (update) and release (read) on the host
+TEST_F(SourceLayersCache, Benchmark) {
+    const unsigned    iterations = 100000;
+    volatile uint8_t  sink       = 0;
+    auto              start      = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        keypos_t key = {.col = (uint8_t)(i % MATRIX_COLS), .row = (uint8_t)((i / MATRIX_COLS) % MATRIX_ROWS)};
+        update_source_layers_cache(key, i % MAX_LAYER);
+        sink = read_source_layers_cache(key);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    (void)sink;
+
+    std::cout << "source layers cache, update + read: " << std::chrono::duration<double, std::nano>(elapsed).count() / iterations << " ns" << std::endl;
+}
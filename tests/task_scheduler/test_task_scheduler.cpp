@@ -0,0 +1,114 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <string>
+
+extern "C" {
+#include "task_scheduler.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::InSequence;
+
+static std::string calls;
+static bool        slow_task_is_slow = false;
+
+static void input_task(void) { calls += "i"; }
+static void periodic_task(void) { calls += "p"; }
+static void slow_task(void) {
+    calls += "s";
+    if (slow_task_is_slow) {
+        // takes longer than the whole budget
+        advance_time(2);
+    }
+}
+static void display_task(void) { calls += "d"; }
+
+class TaskScheduler : public TestFixture {
+   public:
+    static void SetUpTestCase() {
+        TestFixture::SetUpTestCase();
+        // registered out of priority order on purpose
+        task_scheduler_register(display_task, 0, TASK_PRIORITY_DISPLAY);
+        task_scheduler_register(slow_task, 0, TASK_PRIORITY_LIGHTING);
+        task_scheduler_register(periodic_task, 10, TASK_PRIORITY_DEFAULT);
+        task_scheduler_register(input_task, 0, TASK_PRIORITY_INPUT);
+    }
+
+    void SetUp() override {
+        calls.clear();
+        slow_task_is_slow = false;
+        task_scheduler_clear_stats();
+    }
+};
+
+TEST_F(TaskScheduler, TasksCanOnlyBeRegisteredOnce) { EXPECT_FALSE(task_scheduler_register(input_task, 0, TASK_PRIORITY_INPUT)); }
+
+TEST_F(TaskScheduler, TasksRunInPriorityOrder) {
+    TestDriver driver;
+    idle_for(10);
+    calls.clear();
+    run_one_scan_loop();
+    EXPECT_EQ(calls, "ipsd");
+}
+
+TEST_F(TaskScheduler, PeriodicTasksRunOncePerPeriod) {
+    TestDriver driver;
+    idle_for(100);
+    const scheduled_task_t *periodic = task_scheduler_get(1);
+    ASSERT_EQ(periodic->func, periodic_task);
+    EXPECT_EQ(periodic->runs, 10);
+    EXPECT_EQ(task_scheduler_get(0)->runs, 100);
+}
+
+TEST_F(TaskScheduler, TasksOverTheBudgetAreDeferredButNotStarved) {
+    TestDriver driver;
+    slow_task_is_slow = true;
+    for (int i = 0; i < 2 * (TASK_SCHEDULER_MAX_DEFERRALS + 1); i++) {
+        keyboard_task();
+    }
+    const scheduled_task_t *display = task_scheduler_get(3);
+    ASSERT_EQ(display->func, display_task);
+    EXPECT_EQ(display->runs, 2);
+    EXPECT_EQ(display->deferred, 2 * TASK_SCHEDULER_MAX_DEFERRALS);
+    // matrix scanning and the input task are never deferred
+    EXPECT_EQ(task_scheduler_get(0)->runs, 2 * (TASK_SCHEDULER_MAX_DEFERRALS + 1));
+}
+
+TEST_F(TaskScheduler, InputTasksRunWhenTheScanIsOverTheBudget) {
+    for (int i = 0; i < TASK_SCHEDULER_MAX_DEFERRALS; i++) {
+        task_scheduler_run(timer_read_us() - 2 * TASK_SCHEDULER_BUDGET_US);
+    }
+    EXPECT_EQ(task_scheduler_get(0)->runs, TASK_SCHEDULER_MAX_DEFERRALS);
+    EXPECT_EQ(task_scheduler_get(0)->deferred, 0);
+    // while the other tasks are deferred
+    EXPECT_GT(task_scheduler_get(3)->deferred, 0);
+}
+
+TEST_F(TaskScheduler, KeysAreStillProcessed) {
+    TestDriver driver;
+    InSequence s;
+    slow_task_is_slow = true;
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    keyboard_task();
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
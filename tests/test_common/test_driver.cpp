@@ -33,4 +33,4 @@ void TestDriver::send_mouse(report_mouse_t* report) { m_this->send_mouse_mock(*r
 
 void TestDriver::send_system(uint16_t data) { m_this->send_system_mock(data); }
 
-void TestDriver::send_consumer(uint16_t data) { m_this->send_consumer(data); }
+void TestDriver::send_consumer(uint16_t data) { m_this->send_consumer_mock(data); }
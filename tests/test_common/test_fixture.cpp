@@ -13,6 +13,9 @@ extern "C" {
 extern "C" {
 void set_time(uint32_t t);
 void advance_time(uint32_t ms);
+void advance_time_us(uint32_t us);
+bool get_next_deadline(uint32_t *us);
+void clear_deadline(void);
 }
 
 using testing::_;
@@ -45,11 +48,35 @@ TestFixture::~TestFixture() {
 
 void TestFixture::run_one_scan_loop() {
     keyboard_task();
-    advance_time(1);
+    scans++;
+    advance_time_us(scan_interval_us);
 }
 
 void TestFixture::idle_for(unsigned time) {
-    for (unsigned i = 0; i < time; i++) {
-        run_one_scan_loop();
+    uint64_t now = 0;
+    uint64_t end = time * 1000ULL;
+    while (now < end) {
+        clear_deadline();
+        keyboard_task();
+        scans++;
+
+        uint64_t next = now + scan_interval_us;
+        if (fast_forward) {
+            // nothing changes until the next deadline (or the end if there is none)
+            uint32_t deadline;
+            uint64_t until = get_next_deadline(&deadline) ? now + deadline : end;
+            if (until > next) {
+                next = until;
+            }
+        }
+        if (next > end) {
+            next = end;
+        }
+        advance_time_us(next - now);
+        now = next;
     }
 }
+
+void TestFixture::set_scan_interval_us(unsigned us) { scan_interval_us = us; }
+
+void TestFixture::set_fast_forward(bool enabled) { fast_forward = enabled; }
@@ -27,4 +27,16 @@ public:
 
     void run_one_scan_loop();
     void idle_for(unsigned ms);
+
+    /* simulated time between two scans, 1ms by default */
+    void set_scan_interval_us(unsigned us);
+    /* let idle_for() skip straight to the next deadline registered with timer_deadline() */
+    void set_fast_forward(bool enabled);
+    /* number of keyboard_task() calls made by run_one_scan_loop() and idle_for() */
+    unsigned scan_loops() const { return scans; }
+
+   private:
+    unsigned scan_interval_us = 1000;
+    bool     fast_forward     = false;
+    unsigned scans            = 0;
 };
\ No newline at end of file
@@ -0,0 +1,78 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+
+using testing::_;
+using testing::InSequence;
+
+class TimeSimulation : public TestFixture {};
+
+TEST_F(TimeSimulation, ScanIntervalSetsTheScanRate) {
+    TestDriver driver;
+    set_scan_interval_us(250);
+    uint16_t start = timer_read();
+    idle_for(10);
+    EXPECT_EQ(scan_loops(), 40);
+    EXPECT_EQ(timer_elapsed(start), 10);
+}
+
+TEST_F(TimeSimulation, FastForwardSkipsIdleScans) {
+    TestDriver driver;
+    set_fast_forward(true);
+    uint16_t start = timer_read();
+    idle_for(1000);
+    EXPECT_EQ(scan_loops(), 1);
+    EXPECT_EQ(timer_elapsed(start), 1000);
+}
+
+TEST_F(TimeSimulation, FastForwardStopsAtTheTappingTerm) {
+    TestDriver driver;
+    InSequence s;
+    set_fast_forward(true);
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM - 1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    idle_for(1000);
+    EXPECT_LE(scan_loops(), 4);
+
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A)));
+    run_one_scan_loop();
+    release_key(0, 0);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+}
+
+TEST_F(TimeSimulation, FastForwardKeepsTaps) {
+    TestDriver driver;
+    InSequence s;
+    set_fast_forward(true);
+
+    press_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(TAPPING_TERM / 2);
+    release_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(TAPPING_TERM);
+    EXPECT_LE(scan_loops(), 4);
+}
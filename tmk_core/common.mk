@@ -98,6 +98,21 @@ ifeq ($(strip $(COMMAND_ENABLE)), yes)
     TMK_COMMON_DEFS += -DCOMMAND_ENABLE
 endif
 
+ifeq ($(strip $(TASK_SCHEDULER_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/task_scheduler.c
+    TMK_COMMON_DEFS += -DTASK_SCHEDULER_ENABLE
+endif
+
+ifeq ($(strip $(PERF_STATS_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/perf_stats.c
+    TMK_COMMON_DEFS += -DPERF_STATS_ENABLE
+endif
+
+ifeq ($(strip $(LATENCY_TRACE_ENABLE)), yes)
+    TMK_COMMON_SRC += $(COMMON_DIR)/latency_trace.c
+    TMK_COMMON_DEFS += -DLATENCY_TRACE_ENABLE
+endif
+
 ifeq ($(strip $(NKRO_ENABLE)), yes)
     ifeq ($(PROTOCOL), VUSB)
         $(info NKRO is not currently supported on V-USB, and has been disabled.)
@@ -26,6 +26,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action_util.h"
 #include "action.h"
 #include "wait.h"
+#include "latency_trace.h"
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -62,6 +63,7 @@ __attribute__((weak)) bool get_ignore_mod_tap_interrupt(uint16_t keycode, keyrec
  * FIXME: Needs documentation.
  */
 void action_exec(keyevent_t event) {
+    LATENCY_TRACE_BEGIN(event);
     if (!IS_NOEVENT(event)) {
         dprint("\n---- action_exec: start -----\n");
         dprint("EVENT: ");
@@ -116,6 +118,7 @@ void action_exec(keyevent_t event) {
         dprintln();
     }
 #endif
+    LATENCY_TRACE_END();
 }
 
 #ifdef SWAP_HANDS_ENABLE
@@ -191,6 +194,7 @@ void process_record(keyrecord_t *record) {
     if (IS_NOEVENT(record->event)) {
         return;
     }
+    LATENCY_TRACE_BEGIN(record->event);
 
     if (!process_record_quantum(record)) {
 #ifndef NO_ACTION_ONESHOT
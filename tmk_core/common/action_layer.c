@@ -1,8 +1,12 @@
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "action.h"
 #include "util.h"
 #include "action_layer.h"
+#ifdef RESOLVED_ACTION_CACHE
+#    include "keycode_config.h"
+#endif
 
 #ifdef DEBUG_ACTION
 #    include "debug.h"
@@ -182,6 +186,49 @@ void layer_debug(void) { dprintf("%08lX(%u)", layer_state, get_highest_layer(lay
 #endif
 
 #if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
+#    ifdef SOURCE_LAYERS_CACHE_PER_KEY
+/** \brief source layer cache
+ *
+ * One nibble per key when the layer number fits in four bits, one byte per key otherwise.
+ * Costs more RAM than the bit-sliced layout, but is a single read (and write) per event.
+ */
+#        if MAX_LAYER_BITS <= 4
+#            define SOURCE_LAYERS_CACHE_NIBBLES
+uint8_t source_layers_cache[(MATRIX_ROWS * MATRIX_COLS + 1) / 2] = {0};
+#        else
+uint8_t source_layers_cache[MATRIX_ROWS * MATRIX_COLS] = {0};
+#        endif
+
+/** \brief update source layers cache
+ *
+ * Updates the cached keys when changing layers
+ */
+void update_source_layers_cache(keypos_t key, uint8_t layer) {
+    const uint16_t key_number = key.col + (key.row * MATRIX_COLS);
+
+#        ifdef SOURCE_LAYERS_CACHE_NIBBLES
+    const uint8_t shift = (key_number & 1) * 4;
+
+    source_layers_cache[key_number / 2] = (source_layers_cache[key_number / 2] & ~(0x0F << shift)) | (layer << shift);
+#        else
+    source_layers_cache[key_number] = layer;
+#        endif
+}
+
+/** \brief read source layers cache
+ *
+ * reads the cached keys stored when the layer was changed
+ */
+uint8_t read_source_layers_cache(keypos_t key) {
+    const uint16_t key_number = key.col + (key.row * MATRIX_COLS);
+
+#        ifdef SOURCE_LAYERS_CACHE_NIBBLES
+    return (source_layers_cache[key_number / 2] >> ((key_number & 1) * 4)) & 0x0F;
+#        else
+    return source_layers_cache[key_number];
+#        endif
+}
+#    else
 /** \brief source layer cache
  */
 
@@ -192,9 +239,9 @@ uint8_t source_layers_cache[(MATRIX_ROWS * MATRIX_COLS + 7) / 8][MAX_LAYER_BITS]
  * Updates the cached keys when changing layers
  */
 void update_source_layers_cache(keypos_t key, uint8_t layer) {
-    const uint8_t key_number  = key.col + (key.row * MATRIX_COLS);
-    const uint8_t storage_row = key_number / 8;
-    const uint8_t storage_bit = key_number % 8;
+    const uint16_t key_number  = key.col + (key.row * MATRIX_COLS);
+    const uint16_t storage_row = key_number / 8;
+    const uint8_t  storage_bit = key_number % 8;
 
     for (uint8_t bit_number = 0; bit_number < MAX_LAYER_BITS; bit_number++) {
         source_layers_cache[storage_row][bit_number] ^= (-((layer & (1U << bit_number)) != 0) ^ source_layers_cache[storage_row][bit_number]) & (1U << storage_bit);
@@ -206,10 +253,10 @@ void update_source_layers_cache(keypos_t key, uint8_t layer) {
  * reads the cached keys stored when the layer was changed
  */
 uint8_t read_source_layers_cache(keypos_t key) {
-    const uint8_t key_number  = key.col + (key.row * MATRIX_COLS);
-    const uint8_t storage_row = key_number / 8;
-    const uint8_t storage_bit = key_number % 8;
-    uint8_t       layer       = 0;
+    const uint16_t key_number  = key.col + (key.row * MATRIX_COLS);
+    const uint16_t storage_row = key_number / 8;
+    const uint8_t  storage_bit = key_number % 8;
+    uint8_t        layer       = 0;
 
     for (uint8_t bit_number = 0; bit_number < MAX_LAYER_BITS; bit_number++) {
         layer |= ((source_layers_cache[storage_row][bit_number] & (1U << storage_bit)) != 0) << bit_number;
@@ -217,8 +264,11 @@ uint8_t read_source_layers_cache(keypos_t key) {
 
     return layer;
 }
+#    endif
 #endif
 
+static action_t layer_action_for_key(uint8_t layer, keypos_t key);
+
 /** \brief Store or get action (FIXME: Needs better summary)
  *
  * Make sure the action triggered when the key is released is the same
@@ -240,40 +290,145 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
     } else {
         layer = read_source_layers_cache(key);
     }
-    return action_for_key(layer, key);
+    return layer_action_for_key(layer, key);
 #else
     return layer_switch_get_action(key);
 #endif
 }
 
+#if !defined(NO_ACTION_LAYER) && defined(RESOLVED_LAYER_CACHE)
+/** \brief resolved layer cache
+ *
+ * Topmost non-transparent layer of each key for the layer state in resolved_layer_cache_state,
+ * or RESOLVED_LAYER_UNKNOWN if it hasn't been looked up since the last change.
+ */
+#    define RESOLVED_LAYER_UNKNOWN 0xFF
+
+static uint8_t       resolved_layer_cache[MATRIX_ROWS * MATRIX_COLS];
+static layer_state_t resolved_layer_cache_state = 0;
+static bool          resolved_layer_cache_valid = false;
+#    ifdef RESOLVED_ACTION_CACHE
+/** \brief resolved action cache
+ *
+ * Action of each key on its resolved layer. keycode_config() remaps keycodes depending on
+ * keymap_config, so the cached actions are only valid for the keymap_config they were built with.
+ */
+static action_t resolved_action_cache[MATRIX_ROWS * MATRIX_COLS];
+static uint16_t resolved_action_cache_config = 0;
+#    endif
+
+/** \brief invalidate resolved layer cache
+ *
+ * Call this whenever the keymap itself changes (eg. dynamic keymaps). Layer state changes are picked up automatically.
+ */
+void resolved_layer_cache_invalidate(void) { resolved_layer_cache_valid = false; }
+
+static uint16_t resolved_layer_cache_index(keypos_t key);
+#endif
+
+#ifndef NO_ACTION_LAYER
+static uint8_t resolve_layer(keypos_t key, layer_state_t layers, action_t *action);
+#endif
+
 /** \brief Layer switch get layer
  *
  * Gets the layer based on key info
  */
 uint8_t layer_switch_get_layer(keypos_t key) {
 #ifndef NO_ACTION_LAYER
+#    ifdef RESOLVED_LAYER_CACHE
+    uint16_t index = resolved_layer_cache_index(key);
+    if (index != UINT16_MAX) {
+        return resolved_layer_cache[index];
+    }
+#    endif
     action_t action;
-    action.code = ACTION_TRANSPARENT;
+    return resolve_layer(key, layer_state | default_layer_state, &action);
+#else
+    return get_highest_layer(default_layer_state);
+#endif
+}
+
+#ifndef NO_ACTION_LAYER
+/** \brief Resolve layer
+ *
+ * Walks the active layers from the top to find the first non-transparent one for the key
+ */
+static uint8_t resolve_layer(keypos_t key, layer_state_t layers, action_t *action) {
+    action->code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & (1UL << i)) {
-            action = action_for_key(i, key);
-            if (action.code != ACTION_TRANSPARENT) {
+            *action = action_for_key(i, key);
+            if (action->code != ACTION_TRANSPARENT) {
                 return i;
             }
         }
     }
     /* fall back to layer 0 */
     return 0;
-#else
-    return get_highest_layer(default_layer_state);
+}
+#endif
+
+#if !defined(NO_ACTION_LAYER) && defined(RESOLVED_LAYER_CACHE)
+/** \brief Resolved layer cache index
+ *
+ * Returns the cache slot of the key, resolving it first if necessary, or UINT16_MAX for keys outside the matrix
+ */
+static uint16_t resolved_layer_cache_index(keypos_t key) {
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return UINT16_MAX;
+    }
+
+    layer_state_t layers = layer_state | default_layer_state;
+#    ifdef RESOLVED_ACTION_CACHE
+    if (resolved_action_cache_config != keymap_config.raw) {
+        resolved_action_cache_config = keymap_config.raw;
+        resolved_layer_cache_valid   = false;
+    }
+#    endif
+    if (!resolved_layer_cache_valid || resolved_layer_cache_state != layers) {
+        memset(resolved_layer_cache, RESOLVED_LAYER_UNKNOWN, sizeof(resolved_layer_cache));
+        resolved_layer_cache_state = layers;
+        resolved_layer_cache_valid = true;
+    }
+
+    uint16_t index = key.row * MATRIX_COLS + key.col;
+    if (resolved_layer_cache[index] == RESOLVED_LAYER_UNKNOWN) {
+        action_t action;
+        resolved_layer_cache[index] = resolve_layer(key, layers, &action);
+#    ifdef RESOLVED_ACTION_CACHE
+        if (action.code == ACTION_TRANSPARENT) {
+            // fell back to layer 0 without looking at it
+            action = action_for_key(0, key);
+        }
+        resolved_action_cache[index] = action;
+#    endif
+    }
+    return index;
+}
 #endif
+
+/** \brief Action for key on layer
+ *
+ * Same as action_for_key(), but served from the resolved action cache when the key
+ * has already been resolved to this layer with the current layer state.
+ */
+static action_t layer_action_for_key(uint8_t layer, keypos_t key) {
+#if !defined(NO_ACTION_LAYER) && defined(RESOLVED_ACTION_CACHE)
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS && resolved_layer_cache_valid && resolved_layer_cache_state == (layer_state | default_layer_state) && resolved_action_cache_config == keymap_config.raw) {
+        uint16_t index = key.row * MATRIX_COLS + key.col;
+        if (resolved_layer_cache[index] == layer) {
+            return resolved_action_cache[index];
+        }
+    }
+#endif
+    return action_for_key(layer, key);
 }
 
 /** \brief Layer switch get layer
  *
  * Gets action code based on key position
  */
-action_t layer_switch_get_action(keypos_t key) { return action_for_key(layer_switch_get_layer(key), key); }
+action_t layer_switch_get_action(keypos_t key) { return layer_action_for_key(layer_switch_get_layer(key), key); }
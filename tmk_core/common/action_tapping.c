@@ -85,6 +85,13 @@ void action_tapping_process(keyrecord_t record) {
             break;
         }
     }
+    if (IS_TAPPING()) {
+#    ifdef TAPPING_TERM_PER_KEY
+        timer_deadline(tapping_key.event.time + get_tapping_term(get_event_keycode(tapping_key.event, false), &tapping_key));
+#    else
+        timer_deadline(tapping_key.event.time + TAPPING_TERM);
+#    endif
+    }
     if (!IS_NOEVENT(record.event)) {
         debug("\n");
     }
@@ -16,4 +16,7 @@ uint16_t timer_elapsed(uint16_t tlast) { return TIMER_DIFF_16(timer_read(), tlas
 
 uint32_t timer_elapsed32(uint32_t tlast) { return TIMER_DIFF_32(timer_read32(), tlast); }
 
+// Only millisecond resolution for now
+uint32_t timer_read_us(void) { return (uint32_t)ms_clk * 1000; }
+
 void timer_clear(void) { set_time(0); }
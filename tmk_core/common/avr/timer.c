@@ -124,6 +124,34 @@ inline uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(t, last);
 }
 
+#if defined(__AVR_ATmega32A__)
+#    define TIMER_INTERRUPT_PENDING (TIFR & _BV(OCF0))
+#elif defined(__AVR_ATtiny85__)
+#    define TIMER_INTERRUPT_PENDING (TIFR & _BV(OCF0A))
+#else
+#    define TIMER_INTERRUPT_PENDING (TIFR0 & _BV(OCF0A))
+#endif
+
+/** \brief timer read microseconds
+ *
+ * Combines the millisecond count with the Timer0 counter, so the resolution is one Timer0 tick (4us at 16MHz)
+ */
+uint32_t timer_read_us(void) {
+    uint32_t t;
+    uint8_t  raw;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        t   = timer_count;
+        raw = TIMER_RAW;
+        // Timer0 has already wrapped, but the interrupt couldn't run yet
+        if (TIMER_INTERRUPT_PENDING && raw < TIMER_RAW_TOP / 2) {
+            t++;
+        }
+    }
+
+    return t * 1000 + (uint32_t)raw * 1000 / (TIMER_RAW_TOP + 1);
+}
+
 // excecuted once per 1ms.(excess for just timer count?)
 #ifndef __AVR_ATmega32A__
 #    define TIMER_INTERRUPT_VECTOR TIMER0_COMPA_vect
@@ -47,6 +47,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    include "audio.h"
 #endif /* AUDIO_ENABLE */
 
+#ifdef PERF_STATS_ENABLE
+#    include "perf_stats.h"
+#endif
+
+#ifdef LATENCY_TRACE_ENABLE
+#    include "latency_trace.h"
+#endif
+
+#ifdef SPLIT_TRANSPORT_STATS
+#    include "split_stats.h"
+#endif
+
 static bool command_common(uint8_t code);
 static void command_common_help(void);
 static void print_version(void);
@@ -512,6 +524,18 @@ static void command_console_help(void) {
           "ESC/q:	quit\n"
 #ifdef MOUSEKEY_ENABLE
           "m:	mousekey\n"
+#endif
+#ifdef PERF_STATS_ENABLE
+          "p:	timing statistics\n"
+          "r:	reset timing statistics\n"
+#endif
+#ifdef LATENCY_TRACE_ENABLE
+          "l:	key latency\n"
+          "c:	clear key latency\n"
+#endif
+#ifdef SPLIT_TRANSPORT_STATS
+          "s:	split link statistics\n"
+          "x:	clear split link statistics\n"
 #endif
     );
 }
@@ -532,6 +556,30 @@ static bool command_console(uint8_t code) {
             print("M> ");
             command_state = MOUSEKEY;
             return true;
+#endif
+#ifdef PERF_STATS_ENABLE
+        case KC_P:
+            perf_stats_print();
+            break;
+        case KC_R:
+            perf_stats_clear();
+            break;
+#endif
+#ifdef LATENCY_TRACE_ENABLE
+        case KC_L:
+            latency_trace_print();
+            break;
+        case KC_C:
+            latency_trace_clear();
+            break;
+#endif
+#ifdef SPLIT_TRANSPORT_STATS
+        case KC_S:
+            split_stats_print();
+            break;
+        case KC_X:
+            split_stats_clear();
+            break;
 #endif
         default:
             print("?");
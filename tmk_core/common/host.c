@@ -21,6 +21,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "host.h"
 #include "util.h"
 #include "debug.h"
+#include "perf_stats.h"
+#include "latency_trace.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -31,6 +33,16 @@ static host_driver_t *driver;
 static uint16_t       last_system_report   = 0;
 static uint16_t       last_consumer_report = 0;
 
+#ifdef QMK_BATCH_KEY_EVENTS
+static bool              keyboard_send_deferred = false;
+static bool              keyboard_report_queued = false;
+static report_keyboard_t keyboard_report_pending;
+static report_keyboard_t keyboard_report_last;
+#    ifdef LATENCY_TRACE_ENABLE
+static keyevent_t keyboard_report_pending_event;
+#    endif
+#endif
+
 void host_set_driver(host_driver_t *d) { driver = d; }
 
 host_driver_t *host_get_driver(void) { return driver; }
@@ -45,9 +57,7 @@ led_t host_keyboard_led_state(void) {
     return (led_t)((*driver->keyboard_leds)());
 }
 
-/* send report */
-void host_keyboard_send(report_keyboard_t *report) {
-    if (!driver) return;
+static void send_keyboard_report(report_keyboard_t *report) {
 #if defined(NKRO_ENABLE) && defined(NKRO_SHARED_EP)
     if (keyboard_protocol && keymap_config.nkro) {
         /* The callers of this function assume that report->mods is where mods go in.
@@ -62,7 +72,9 @@ void host_keyboard_send(report_keyboard_t *report) {
         report->report_id = REPORT_ID_KEYBOARD;
 #endif
     }
+    PERF_STATS_BEGIN(PERF_STATS_SEND_REPORT);
     (*driver->send_keyboard)(report);
+    PERF_STATS_END(PERF_STATS_SEND_REPORT);
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -73,12 +85,102 @@ void host_keyboard_send(report_keyboard_t *report) {
     }
 }
 
+#ifdef QMK_BATCH_KEY_EVENTS
+/** \brief Checks if a key or mod toggled by `pending` is toggled back by `next`
+ *
+ * Coalescing such a pair of reports would hide a tap (or a release) from the host.
+ */
+static bool keyboard_report_reverts(report_keyboard_t *last, report_keyboard_t *pending, report_keyboard_t *next) {
+    if ((last->mods ^ pending->mods) & (pending->mods ^ next->mods)) {
+        return true;
+    }
+#    ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        for (uint8_t i = 0; i < KEYBOARD_REPORT_BITS; i++) {
+            if ((last->nkro.bits[i] ^ pending->nkro.bits[i]) & (pending->nkro.bits[i] ^ next->nkro.bits[i])) {
+                return true;
+            }
+        }
+        return false;
+    }
+#    endif
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        // pressed since the last report, released again
+        if (pending->keys[i] && !is_key_pressed(last, pending->keys[i]) && !is_key_pressed(next, pending->keys[i])) {
+            return true;
+        }
+        // released since the last report, pressed again
+        if (last->keys[i] && !is_key_pressed(pending, last->keys[i]) && is_key_pressed(next, last->keys[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** \brief Send the queued keyboard report, if any
+ */
+static void flush_keyboard_report(void) {
+    if (!keyboard_report_queued) {
+        return;
+    }
+    keyboard_report_queued = false;
+    keyboard_report_last   = keyboard_report_pending;
+#    ifdef LATENCY_TRACE_ENABLE
+    latency_trace_record(keyboard_report_pending_event);
+#    endif
+    send_keyboard_report(&keyboard_report_pending);
+}
+
+/** \brief Defer keyboard reports
+ *
+ * While deferred, each keyboard report replaces the previous one unless that would lose a
+ * state change the host has to see. Ending the deferral sends the final state, if any. The
+ * other reports are not deferred, they send the queued keyboard report first to keep the order.
+ */
+void host_keyboard_send_defer(bool defer) {
+    keyboard_send_deferred = defer;
+    if (!defer) {
+        flush_keyboard_report();
+    }
+}
+#endif
+
+/* send report */
+void host_keyboard_send(report_keyboard_t *report) {
+    if (!driver) return;
+#ifdef QMK_BATCH_KEY_EVENTS
+    if (keyboard_send_deferred) {
+        if (keyboard_report_queued && keyboard_report_reverts(&keyboard_report_last, &keyboard_report_pending, report)) {
+            flush_keyboard_report();
+        }
+#    ifdef LATENCY_TRACE_ENABLE
+        // a coalesced report is as late as the oldest event in it
+        keyevent_t event = latency_trace_take();
+        if (!keyboard_report_queued || !keyboard_report_pending_event.detected_us) {
+            keyboard_report_pending_event = event;
+        }
+#    endif
+        keyboard_report_pending = *report;
+        keyboard_report_queued  = true;
+        return;
+    }
+    keyboard_report_last = *report;
+#endif
+    LATENCY_TRACE_REPORT();
+    send_keyboard_report(report);
+}
+
 void host_mouse_send(report_mouse_t *report) {
     if (!driver) return;
+#ifdef QMK_BATCH_KEY_EVENTS
+    flush_keyboard_report();
+#endif
 #ifdef MOUSE_SHARED_EP
     report->report_id = REPORT_ID_MOUSE;
 #endif
+    PERF_STATS_BEGIN(PERF_STATS_SEND_REPORT);
     (*driver->send_mouse)(report);
+    PERF_STATS_END(PERF_STATS_SEND_REPORT);
 }
 
 void host_system_send(uint16_t report) {
@@ -86,7 +188,12 @@ void host_system_send(uint16_t report) {
     last_system_report = report;
 
     if (!driver) return;
+#ifdef QMK_BATCH_KEY_EVENTS
+    flush_keyboard_report();
+#endif
+    PERF_STATS_BEGIN(PERF_STATS_SEND_REPORT);
     (*driver->send_system)(report);
+    PERF_STATS_END(PERF_STATS_SEND_REPORT);
 }
 
 void host_consumer_send(uint16_t report) {
@@ -94,7 +201,12 @@ void host_consumer_send(uint16_t report) {
     last_consumer_report = report;
 
     if (!driver) return;
+#ifdef QMK_BATCH_KEY_EVENTS
+    flush_keyboard_report();
+#endif
+    PERF_STATS_BEGIN(PERF_STATS_SEND_REPORT);
     (*driver->send_consumer)(report);
+    PERF_STATS_END(PERF_STATS_SEND_REPORT);
 }
 
 uint16_t host_last_system_report(void) { return last_system_report; }
@@ -48,6 +48,10 @@ void    host_mouse_send(report_mouse_t *report);
 void    host_system_send(uint16_t data);
 void    host_consumer_send(uint16_t data);
 
+#ifdef QMK_BATCH_KEY_EVENTS
+void host_keyboard_send_defer(bool defer);
+#endif
+
 uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 
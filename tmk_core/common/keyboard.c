@@ -95,6 +95,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
 #endif
+#ifdef TASK_SCHEDULER_ENABLE
+#    include "task_scheduler.h"
+#endif
+#include "perf_stats.h"
+#include "latency_trace.h"
 
 // Only enable this if console is enabled to print to
 #if defined(DEBUG_MATRIX_SCAN_RATE) && defined(CONSOLE_ENABLE)
@@ -116,20 +121,29 @@ void matrix_scan_perf_task(void) {
 #    define matrix_scan_perf_task()
 #endif
 
+#if defined(QMK_BATCH_KEY_EVENTS) && !defined(QMK_BATCH_QUEUE_SIZE)
+#    define QMK_BATCH_QUEUE_SIZE 16
+#endif
+
 #ifdef MATRIX_HAS_GHOST
 extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
-static matrix_row_t   get_real_keys(uint8_t row, matrix_row_t rowdata) {
-    matrix_row_t out = 0;
-    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-        // read each key in the row data and check if the keymap defines it as a real key
-        if (pgm_read_byte(&keymaps[0][row][col]) && (rowdata & (1 << col))) {
-            // this creates new row data, if a key is defined in the keymap, it will be set here
-            out |= 1 << col;
+
+/* the keys of each row that are defined in the base layer, blanks can't be pressed */
+static matrix_row_t real_keys[MATRIX_ROWS];
+
+static void init_real_keys(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        real_keys[row] = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (pgm_read_word(&keymaps[0][row][col])) {
+                real_keys[row] |= MATRIX_ROW_SHIFTER << col;
+            }
         }
     }
-    return out;
 }
 
+static inline matrix_row_t get_real_keys(uint8_t row, matrix_row_t rowdata) { return rowdata & real_keys[row]; }
+
 static inline bool popcount_more_than_one(matrix_row_t rowdata) {
     rowdata &= rowdata - 1;  // if there are less than two bits (keys) set, rowdata will become zero
     return rowdata;
@@ -229,6 +243,72 @@ __attribute__((weak)) bool is_keyboard_master(void) { return true; }
  */
 __attribute__((weak)) bool should_process_keypress(void) { return is_keyboard_master(); }
 
+#ifdef TASK_SCHEDULER_ENABLE
+#    ifdef VISUALIZER_ENABLE
+static void visualizer_task(void) { visualizer_update(default_layer_state, layer_state, visualizer_get_mods(), host_keyboard_leds()); }
+#    endif
+
+#    ifdef VELOCIKEY_ENABLE
+static void velocikey_task(void) {
+    if (velocikey_enabled()) {
+        velocikey_decelerate();
+    }
+}
+#    endif
+
+/** \brief keyboard_register_tasks
+ *
+ * Hands the periodic feature tasks over to the scheduler, see keyboard_task()
+ */
+static void keyboard_register_tasks(void) {
+#    if defined(RGBLIGHT_ENABLE)
+    task_scheduler_register(rgblight_task, 0, TASK_PRIORITY_LIGHTING);
+#    endif
+#    if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+    task_scheduler_register(backlight_task, 0, TASK_PRIORITY_LIGHTING);
+#    endif
+#    ifdef ENCODER_ENABLE
+    task_scheduler_register(encoder_read, 0, TASK_PRIORITY_INPUT);
+#    endif
+#    ifdef QWIIC_ENABLE
+    task_scheduler_register(qwiic_task, 0, TASK_PRIORITY_DISPLAY);
+#    endif
+#    ifdef OLED_DRIVER_ENABLE
+    task_scheduler_register(oled_task, 0, TASK_PRIORITY_DISPLAY);
+#    endif
+#    ifdef MOUSEKEY_ENABLE
+    task_scheduler_register(mousekey_task, 0, TASK_PRIORITY_INPUT);
+#    endif
+#    ifdef PS2_MOUSE_ENABLE
+    task_scheduler_register(ps2_mouse_task, 0, TASK_PRIORITY_INPUT);
+#    endif
+#    ifdef SERIAL_MOUSE_ENABLE
+    task_scheduler_register(serial_mouse_task, 0, TASK_PRIORITY_INPUT);
+#    endif
+#    ifdef ADB_MOUSE_ENABLE
+    task_scheduler_register(adb_mouse_task, 0, TASK_PRIORITY_INPUT);
+#    endif
+#    ifdef SERIAL_LINK_ENABLE
+    task_scheduler_register(serial_link_update, 0, TASK_PRIORITY_DEFAULT);
+#    endif
+#    ifdef VISUALIZER_ENABLE
+    task_scheduler_register(visualizer_task, 0, TASK_PRIORITY_DISPLAY);
+#    endif
+#    ifdef POINTING_DEVICE_ENABLE
+    task_scheduler_register(pointing_device_task, 0, TASK_PRIORITY_INPUT);
+#    endif
+#    ifdef MIDI_ENABLE
+    task_scheduler_register(midi_task, 0, TASK_PRIORITY_DEFAULT);
+#    endif
+#    ifdef VELOCIKEY_ENABLE
+    task_scheduler_register(velocikey_task, 0, TASK_PRIORITY_LIGHTING);
+#    endif
+#    ifdef JOYSTICK_ENABLE
+    task_scheduler_register(joystick_task, 0, TASK_PRIORITY_INPUT);
+#    endif
+}
+#endif
+
 /** \brief keyboard_init
  *
  * FIXME: needs doc
@@ -236,6 +316,9 @@ __attribute__((weak)) bool should_process_keypress(void) { return is_keyboard_ma
 void keyboard_init(void) {
     timer_init();
     matrix_init();
+#ifdef MATRIX_HAS_GHOST
+    init_real_keys();
+#endif
 #ifdef VIA_ENABLE
     via_init();
 #endif
@@ -284,6 +367,9 @@ void keyboard_init(void) {
 #ifdef DIP_SWITCH_ENABLE
     dip_switch_init();
 #endif
+#ifdef TASK_SCHEDULER_ENABLE
+    keyboard_register_tasks();
+#endif
 
     keyboard_post_init_kb(); /* Always keep this last */
 }
@@ -305,17 +391,33 @@ void keyboard_task(void) {
     static uint8_t      led_status    = 0;
     matrix_row_t        matrix_row    = 0;
     matrix_row_t        matrix_change = 0;
+#ifdef QMK_BATCH_KEY_EVENTS
+    static keyevent_t event_queue[QMK_BATCH_QUEUE_SIZE];
+    uint8_t           events_queued = 0;
+#endif
 #ifdef QMK_KEYS_PER_SCAN
     uint8_t keys_processed = 0;
 #endif
+#ifdef TASK_SCHEDULER_ENABLE
+    uint32_t loop_start = timer_read_us();
+#endif
+    PERF_STATS_BEGIN(PERF_STATS_SCAN_LOOP);
+#ifdef LATENCY_TRACE_ENABLE
+    uint32_t scan_us = timer_read_us() | 1; /* 0 means not traced */
+#endif
 
+    PERF_STATS_BEGIN(PERF_STATS_MATRIX_SCAN);
 #if defined(OLED_DRIVER_ENABLE) && !defined(OLED_DISABLE_TIMEOUT)
     uint8_t ret = matrix_scan();
 #else
     matrix_scan();
 #endif
+    PERF_STATS_END(PERF_STATS_MATRIX_SCAN);
 
     if (should_process_keypress()) {
+#ifdef QMK_BATCH_KEY_EVENTS
+        uint16_t scan_time = timer_read() | 1; /* time should not be 0 */
+#endif
         for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
             matrix_row    = matrix_get_row(r);
             matrix_change = matrix_row ^ matrix_prev[r];
@@ -329,22 +431,59 @@ void keyboard_task(void) {
                 matrix_row_t col_mask = 1;
                 for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
                     if (matrix_change & col_mask) {
-                        action_exec((keyevent_t){
+#ifdef QMK_BATCH_KEY_EVENTS
+                        // queue every change of this scan, in scan order
+                        event_queue[events_queued] = (keyevent_t){.key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = scan_time};
+#    ifdef LATENCY_TRACE_ENABLE
+                        event_queue[events_queued].detected_us = scan_us;
+#    endif
+                        events_queued++;
+                        matrix_prev[r] ^= col_mask;
+                        // anything that doesn't fit is picked up by the next scan
+                        if (events_queued >= QMK_BATCH_QUEUE_SIZE) {
+                            timer_deadline(timer_read());
+                            goto MATRIX_QUEUE_FULL;
+                        }
+#else
+                        keyevent_t event = {
                             .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
+                        };
+#    ifdef LATENCY_TRACE_ENABLE
+                        event.detected_us = scan_us;
+#    endif
+                        PERF_STATS_BEGIN(PERF_STATS_ACTION_EXEC);
+                        action_exec(event);
+                        PERF_STATS_END(PERF_STATS_ACTION_EXEC);
                         // record a processed key
                         matrix_prev[r] ^= col_mask;
-#ifdef QMK_KEYS_PER_SCAN
+                        // other changes are picked up by the next scan
+                        timer_deadline(timer_read());
+#    ifdef QMK_KEYS_PER_SCAN
                         // only jump out if we have processed "enough" keys.
                         if (++keys_processed >= QMK_KEYS_PER_SCAN)
-#endif
+#    endif
                             // process a key per task call
                             goto MATRIX_LOOP_END;
+#endif
                     }
                 }
             }
         }
     }
+#ifdef QMK_BATCH_KEY_EVENTS
+MATRIX_QUEUE_FULL:
+    if (events_queued) {
+        // run the whole batch, only sending the keyboard reports the host needs to see
+        host_keyboard_send_defer(true);
+        for (uint8_t i = 0; i < events_queued; i++) {
+            PERF_STATS_BEGIN(PERF_STATS_ACTION_EXEC);
+            action_exec(event_queue[i]);
+            PERF_STATS_END(PERF_STATS_ACTION_EXEC);
+        }
+        host_keyboard_send_defer(false);
+        goto MATRIX_LOOP_END;
+    }
+#endif
     // call with pseudo tick event when no real key event.
 #ifdef QMK_KEYS_PER_SCAN
     // we can get here with some keys processed now.
@@ -354,84 +493,101 @@ void keyboard_task(void) {
 
 MATRIX_LOOP_END:
 
-#ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_scan_perf_task();
-#endif
 
-#if defined(RGBLIGHT_ENABLE)
+    PERF_STATS_BEGIN(PERF_STATS_TASKS);
+#ifdef TASK_SCHEDULER_ENABLE
+    task_scheduler_run(loop_start);
+
+#    if defined(OLED_DRIVER_ENABLE) && !defined(OLED_DISABLE_TIMEOUT)
+    // Wake up oled if user is using those fabulous keys!
+    if (ret) oled_on();
+#    endif
+#else
+#    if defined(RGBLIGHT_ENABLE)
+    PERF_STATS_BEGIN(PERF_STATS_RGBLIGHT);
     rgblight_task();
-#endif
+    PERF_STATS_END(PERF_STATS_RGBLIGHT);
+#    endif
 
-#if defined(BACKLIGHT_ENABLE)
-#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+#    if defined(BACKLIGHT_ENABLE)
+#        if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+    PERF_STATS_BEGIN(PERF_STATS_BACKLIGHT);
     backlight_task();
+    PERF_STATS_END(PERF_STATS_BACKLIGHT);
+#        endif
 #    endif
-#endif
 
-#ifdef ENCODER_ENABLE
+#    ifdef ENCODER_ENABLE
     encoder_read();
-#endif
+#    endif
 
-#ifdef QWIIC_ENABLE
+#    ifdef QWIIC_ENABLE
     qwiic_task();
-#endif
+#    endif
 
-#ifdef OLED_DRIVER_ENABLE
+#    ifdef OLED_DRIVER_ENABLE
+    PERF_STATS_BEGIN(PERF_STATS_OLED);
     oled_task();
-#    ifndef OLED_DISABLE_TIMEOUT
+    PERF_STATS_END(PERF_STATS_OLED);
+#        ifndef OLED_DISABLE_TIMEOUT
     // Wake up oled if user is using those fabulous keys!
     if (ret) oled_on();
+#        endif
 #    endif
-#endif
 
-#ifdef MOUSEKEY_ENABLE
+#    ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
     mousekey_task();
-#endif
+#    endif
 
-#ifdef PS2_MOUSE_ENABLE
+#    ifdef PS2_MOUSE_ENABLE
     ps2_mouse_task();
-#endif
+#    endif
 
-#ifdef SERIAL_MOUSE_ENABLE
+#    ifdef SERIAL_MOUSE_ENABLE
     serial_mouse_task();
-#endif
+#    endif
 
-#ifdef ADB_MOUSE_ENABLE
+#    ifdef ADB_MOUSE_ENABLE
     adb_mouse_task();
-#endif
+#    endif
 
-#ifdef SERIAL_LINK_ENABLE
+#    ifdef SERIAL_LINK_ENABLE
     serial_link_update();
-#endif
+#    endif
 
-#ifdef VISUALIZER_ENABLE
+#    ifdef VISUALIZER_ENABLE
     visualizer_update(default_layer_state, layer_state, visualizer_get_mods(), host_keyboard_leds());
-#endif
+#    endif
 
-#ifdef POINTING_DEVICE_ENABLE
+#    ifdef POINTING_DEVICE_ENABLE
     pointing_device_task();
-#endif
+#    endif
 
-#ifdef MIDI_ENABLE
+#    ifdef MIDI_ENABLE
     midi_task();
-#endif
+#    endif
 
-#ifdef VELOCIKEY_ENABLE
+#    ifdef VELOCIKEY_ENABLE
     if (velocikey_enabled()) {
         velocikey_decelerate();
     }
-#endif
+#    endif
 
-#ifdef JOYSTICK_ENABLE
+#    ifdef JOYSTICK_ENABLE
     joystick_task();
+#    endif
 #endif
+    PERF_STATS_END(PERF_STATS_TASKS);
 
     // update LED
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+
+    PERF_STATS_END(PERF_STATS_SCAN_LOOP);
 }
 
 /** \brief keyboard set leds
@@ -36,6 +36,9 @@ typedef struct {
     keypos_t key;
     bool     pressed;
     uint16_t time;
+#ifdef LATENCY_TRACE_ENABLE
+    uint32_t detected_us;  // timer_read_us() of the scan that detected the event
+#endif
 } keyevent_t;
 
 /* equivalent test of keypos_t */
@@ -0,0 +1,117 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "latency_trace.h"
+#include "timer.h"
+#include "print.h"
+
+static keyevent_t       current_event;
+static latency_stats_t  stats;
+static latency_sample_t samples[LATENCY_TRACE_SAMPLES];
+static uint8_t          sample_head  = 0;
+static uint8_t          sample_count = 0;
+
+void latency_trace_begin(keyevent_t event) {
+    if (!IS_NOEVENT(event) && event.detected_us) {
+        current_event = event;
+    }
+}
+
+void latency_trace_end(void) { current_event.detected_us = 0; }
+
+/** \brief Record the latency of the event being processed
+ */
+void latency_trace_report(void) { latency_trace_record(latency_trace_take()); }
+
+/** \brief Take the stamp of the event being processed, so only one report records it
+ */
+keyevent_t latency_trace_take(void) {
+    keyevent_t event          = current_event;
+    current_event.detected_us = 0;
+    return event;
+}
+
+/** \brief Record the latency of event
+ */
+void latency_trace_record(keyevent_t event) {
+    if (!event.detected_us) {
+        return;
+    }
+
+    // stamps are odd, so that 0 can mean not traced
+    uint32_t latency = (timer_read_us() | 1) - event.detected_us;
+
+    if (!stats.count || latency < stats.min_us) {
+        stats.min_us = latency;
+    }
+    if (latency > stats.max_us) {
+        stats.max_us = latency;
+    }
+    stats.count++;
+    stats.total_us += latency;
+
+    uint8_t  bucket = 0;
+    uint32_t us     = latency >> 7;
+    while (us && bucket < LATENCY_TRACE_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    if (stats.histogram[bucket] < UINT16_MAX) {
+        stats.histogram[bucket]++;
+    }
+
+    samples[sample_head] = (latency_sample_t){.key = event.key, .pressed = event.pressed, .latency_us = latency};
+    sample_head          = (sample_head + 1) % LATENCY_TRACE_SAMPLES;
+    if (sample_count < LATENCY_TRACE_SAMPLES) {
+        sample_count++;
+    }
+}
+
+const latency_stats_t *latency_trace_stats(void) { return &stats; }
+
+const latency_sample_t *latency_trace_sample(uint8_t index) {
+    if (index >= sample_count) {
+        return 0;
+    }
+    return &samples[(sample_head + LATENCY_TRACE_SAMPLES - 1 - index) % LATENCY_TRACE_SAMPLES];
+}
+
+void latency_trace_clear(void) {
+    memset(&stats, 0, sizeof(stats));
+    sample_head  = 0;
+    sample_count = 0;
+}
+
+/** \brief Print the statistics and recent samples to the console
+ */
+void latency_trace_print(void) {
+// Print these variables if NO_PRINT or USER_PRINT are not defined.
+#if !defined(NO_PRINT) && !defined(USER_PRINT)
+    if (!stats.count) {
+        return;
+    }
+    xprintf("latency: n %lu min %lu avg %lu max %lu us |", stats.count, stats.min_us, stats.total_us / stats.count, stats.max_us);
+    for (uint8_t b = 0; b < LATENCY_TRACE_BUCKETS; b++) {
+        xprintf(" %u", stats.histogram[b]);
+    }
+    xprintf("\n");
+    for (uint8_t i = 0; i < sample_count; i++) {
+        const latency_sample_t *sample = latency_trace_sample(i);
+        xprintf("%02X%02X%c %lu us\n", sample->key.row, sample->key.col, sample->pressed ? 'd' : 'u', sample->latency_us);
+    }
+#endif
+}
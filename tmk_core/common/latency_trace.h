@@ -0,0 +1,89 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "keyboard.h"
+
+/* Key to report latency tracing.
+ *
+ * keyboard_task() stamps every key event with the timer_read_us() value of the scan that
+ * detected it (keyevent_t.detected_us). The stamp travels with the event through the tapping
+ * and combo buffers, and when the event finally causes a keyboard report the time between the
+ * scan and host_keyboard_send() is recorded. Only the first report caused by an event counts.
+ * With QMK_BATCH_KEY_EVENTS a queued keyboard report keeps the oldest stamp that went into it
+ * and is recorded when it is actually sent.
+ *
+ * Histogram bucket 0 counts latencies under 128us, bucket n (n > 0) 2^(n+6) to 2^(n+7) - 1us,
+ * and the last bucket everything longer.
+ */
+
+#define LATENCY_TRACE_BUCKETS 16
+
+#ifndef LATENCY_TRACE_SAMPLES
+#    define LATENCY_TRACE_SAMPLES 16
+#endif
+
+typedef struct {
+    keypos_t key;
+    bool     pressed;
+    uint32_t latency_us;
+} latency_sample_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t total_us;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint16_t histogram[LATENCY_TRACE_BUCKETS];
+} latency_stats_t;
+
+#ifdef LATENCY_TRACE_ENABLE
+#    define LATENCY_TRACE_BEGIN(event) latency_trace_begin(event)
+#    define LATENCY_TRACE_END() latency_trace_end()
+#    define LATENCY_TRACE_REPORT() latency_trace_report()
+#else
+#    define LATENCY_TRACE_BEGIN(event)
+#    define LATENCY_TRACE_END()
+#    define LATENCY_TRACE_REPORT()
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* an event is being processed, events without a stamp keep the current one */
+void latency_trace_begin(keyevent_t event);
+/* the event that started action_exec() has been processed */
+void latency_trace_end(void);
+/* a keyboard report is being sent */
+void latency_trace_report(void);
+/* hand the stamp of the event being processed to a report that is sent later */
+keyevent_t latency_trace_take(void);
+/* the report holding the stamp of event is being sent */
+void latency_trace_record(keyevent_t event);
+
+const latency_stats_t *latency_trace_stats(void);
+/* recent samples, 0 is the latest, returns 0 past the recorded ones */
+const latency_sample_t *latency_trace_sample(uint8_t index);
+void                    latency_trace_clear(void);
+void                    latency_trace_print(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,159 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "perf_stats.h"
+#include "print.h"
+#ifdef TASK_SCHEDULER_ENABLE
+#    include "task_scheduler.h"
+#endif
+
+static perf_stats_t stats[PERF_STATS_PROBES];
+static uint32_t     stats_cleared_at = 0;
+
+// Print these variables if NO_PRINT or USER_PRINT are not defined.
+#if !defined(NO_PRINT) && !defined(USER_PRINT)
+static const char *const probe_names[PERF_STATS_PROBES] = {
+    [PERF_STATS_SCAN_LOOP] = "scan loop", [PERF_STATS_MATRIX_SCAN] = "matrix scan", [PERF_STATS_ACTION_EXEC] = "action exec", [PERF_STATS_TASKS] = "tasks", [PERF_STATS_SEND_REPORT] = "send report", [PERF_STATS_RGBLIGHT] = "rgblight", [PERF_STATS_BACKLIGHT] = "backlight", [PERF_STATS_OLED] = "oled", [PERF_STATS_USER] = "user",
+};
+#endif
+
+/** \brief Record one run of a probe
+ */
+void perf_stats_record(uint8_t probe, uint32_t elapsed_us) {
+    if (probe >= PERF_STATS_PROBES) {
+        return;
+    }
+
+    perf_stats_t *s  = &stats[probe];
+    uint16_t      us = elapsed_us > UINT16_MAX ? UINT16_MAX : elapsed_us;
+    if (!s->count || us < s->min_us) {
+        s->min_us = us;
+    }
+    if (us > s->max_us) {
+        s->max_us = us;
+    }
+    s->count++;
+    s->total_us += elapsed_us;
+
+    uint8_t bucket = 0;
+    while (us && bucket < PERF_STATS_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    if (s->histogram[bucket] < UINT16_MAX) {
+        s->histogram[bucket]++;
+    }
+}
+
+const perf_stats_t *perf_stats_get(uint8_t probe) { return probe < PERF_STATS_PROBES ? &stats[probe] : 0; }
+
+uint32_t perf_stats_scan_rate(void) {
+    uint32_t elapsed = timer_elapsed32(stats_cleared_at);
+    return elapsed ? stats[PERF_STATS_SCAN_LOOP].count * 1000 / elapsed : 0;
+}
+
+void perf_stats_clear(void) {
+    memset(stats, 0, sizeof(stats));
+#ifdef TASK_SCHEDULER_ENABLE
+    task_scheduler_clear_stats();
+#endif
+    stats_cleared_at = timer_read32();
+}
+
+/** \brief Print the statistics to the console
+ *
+ * One line per probe with count, min/avg/max in microseconds and the histogram buckets.
+ */
+void perf_stats_print(void) {
+#if !defined(NO_PRINT) && !defined(USER_PRINT)
+    xprintf("scan rate: %lu/s\n", perf_stats_scan_rate());
+    for (uint8_t i = 0; i < PERF_STATS_PROBES; i++) {
+        const perf_stats_t *s = &stats[i];
+        if (!s->count) {
+            continue;
+        }
+        xprintf("%s: n %lu min %u avg %lu max %u us |", probe_names[i], s->count, s->min_us, s->total_us / s->count, s->max_us);
+        for (uint8_t b = 0; b < PERF_STATS_BUCKETS; b++) {
+            xprintf(" %u", s->histogram[b]);
+        }
+        xprintf("\n");
+    }
+#    ifdef TASK_SCHEDULER_ENABLE
+    for (uint8_t i = 0; i < task_scheduler_count(); i++) {
+        const scheduled_task_t *task = task_scheduler_get(i);
+        xprintf("task %u: n %lu avg %lu max %lu us deferred %lu\n", i, task->runs, task->runs ? task->total_us / task->runs : 0, task->max_us, task->deferred);
+    }
+#    endif
+#endif
+}
+
+static void put_u16(uint8_t *data, uint16_t value) {
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+}
+
+static void put_u32(uint8_t *data, uint32_t value) {
+    put_u16(&data[0], value >> 16);
+    put_u16(&data[2], value & 0xFFFF);
+}
+
+/** \brief Answer a raw HID statistics request
+ *
+ * Request: PERF_STATS_RAW_HID_ID, index. Index 0xFF returns the number of probes, the number of
+ * scheduled tasks and the scan rate. Lower indexes return count, min, avg, max and the histogram
+ * of that probe, followed by the scheduled tasks (without min or histogram). All values are big
+ * endian, like the rest of the raw HID protocol. An unknown index is returned as 0xFE.
+ */
+bool perf_stats_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (data[0] != PERF_STATS_RAW_HID_ID || length < 12 + 2 * PERF_STATS_BUCKETS) {
+        return false;
+    }
+
+    uint8_t index = data[1];
+    memset(&data[2], 0, length - 2);
+
+#ifdef TASK_SCHEDULER_ENABLE
+    uint8_t tasks = task_scheduler_count();
+#else
+    uint8_t tasks = 0;
+#endif
+
+    if (index == 0xFF) {
+        data[2] = PERF_STATS_PROBES;
+        data[3] = tasks;
+        put_u32(&data[4], perf_stats_scan_rate());
+    } else if (index < PERF_STATS_PROBES) {
+        const perf_stats_t *s = &stats[index];
+        put_u32(&data[2], s->count);
+        put_u16(&data[6], s->min_us);
+        put_u16(&data[8], s->count ? s->total_us / s->count : 0);
+        put_u16(&data[10], s->max_us);
+        for (uint8_t b = 0; b < PERF_STATS_BUCKETS; b++) {
+            put_u16(&data[12 + 2 * b], s->histogram[b]);
+        }
+#ifdef TASK_SCHEDULER_ENABLE
+    } else if (index - PERF_STATS_PROBES < tasks) {
+        const scheduled_task_t *task = task_scheduler_get(index - PERF_STATS_PROBES);
+        put_u32(&data[2], task->runs);
+        put_u16(&data[8], task->runs ? task->total_us / task->runs : 0);
+        put_u16(&data[10], task->max_us > UINT16_MAX ? UINT16_MAX : task->max_us);
+#endif
+    } else {
+        data[1] = 0xFE;
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timer.h"
+
+/* Timing instrumentation for the main loop.
+ *
+ * Each probe keeps min/avg/max and a histogram of its run times in microseconds. Bucket 0
+ * counts runs under 1us, bucket n (n > 0) counts runs of 2^(n-1) to 2^n - 1us, and the last
+ * bucket everything longer. Wrap the code to measure in PERF_STATS_BEGIN()/PERF_STATS_END(),
+ * both compile to nothing without PERF_STATS_ENABLE.
+ */
+
+#define PERF_STATS_BUCKETS 10
+
+#ifndef PERF_STATS_RAW_HID_ID
+#    define PERF_STATS_RAW_HID_ID 0xF0
+#endif
+
+enum perf_stats_probe {
+    PERF_STATS_SCAN_LOOP,    // the whole of keyboard_task()
+    PERF_STATS_MATRIX_SCAN,  // matrix_scan(), including debounce
+    PERF_STATS_ACTION_EXEC,  // action_exec() of a key event
+    PERF_STATS_TASKS,        // the feature tasks after the matrix loop
+    PERF_STATS_SEND_REPORT,  // handing any report to the host driver
+    PERF_STATS_RGBLIGHT,     // rgblight_task(), the task scheduler times it as a task instead
+    PERF_STATS_BACKLIGHT,    // backlight_task(), likewise
+    PERF_STATS_OLED,         // oled_task(), likewise
+    PERF_STATS_USER,         // free for keyboards and keymaps
+    PERF_STATS_PROBES
+};
+
+typedef struct {
+    uint32_t count;
+    uint32_t total_us;
+    uint16_t min_us;
+    uint16_t max_us;
+    uint16_t histogram[PERF_STATS_BUCKETS];
+} perf_stats_t;
+
+#ifdef PERF_STATS_ENABLE
+#    define PERF_STATS_BEGIN(probe) uint32_t perf_stats_start_##probe = timer_read_us()
+#    define PERF_STATS_END(probe) perf_stats_record(probe, timer_read_us() - perf_stats_start_##probe)
+#else
+#    define PERF_STATS_BEGIN(probe)
+#    define PERF_STATS_END(probe)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void                perf_stats_record(uint8_t probe, uint32_t elapsed_us);
+const perf_stats_t *perf_stats_get(uint8_t probe);
+/* loops per second since the statistics were last cleared */
+uint32_t perf_stats_scan_rate(void);
+void     perf_stats_clear(void);
+void     perf_stats_print(void);
+/* answers a PERF_STATS_RAW_HID_ID request in place, returns false for any other message */
+bool perf_stats_raw_hid_receive(uint8_t *data, uint8_t length);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,127 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "task_scheduler.h"
+#include "timer.h"
+#include "print.h"
+#include "debug.h"
+
+/* kept sorted by priority */
+static scheduled_task_t tasks[TASK_SCHEDULER_MAX_TASKS];
+static uint8_t          task_count = 0;
+
+/** \brief Register a task
+ *
+ * Tasks with the same priority run in registration order.
+ */
+bool task_scheduler_register(task_func_t func, uint16_t period, uint8_t priority) {
+    if (task_count >= TASK_SCHEDULER_MAX_TASKS) {
+        return false;
+    }
+
+    uint8_t i;
+    for (i = 0; i < task_count; i++) {
+        if (tasks[i].func == func) {
+            return false;
+        }
+    }
+
+    i = task_count++;
+    for (; i > 0 && tasks[i - 1].priority > priority; i--) {
+        tasks[i] = tasks[i - 1];
+    }
+    tasks[i] = (scheduled_task_t){.func = func, .period = period, .priority = priority, .last_run = timer_read()};
+    return true;
+}
+
+/** \brief Set the period of a task
+ *
+ * Lets keyboards and keymaps slow down (or speed up) a built in task, eg. from keyboard_post_init_user().
+ */
+void task_scheduler_set_period(task_func_t func, uint16_t period) {
+    for (uint8_t i = 0; i < task_count; i++) {
+        if (tasks[i].func == func) {
+            tasks[i].period = period;
+        }
+    }
+}
+
+/** \brief Run the due tasks
+ *
+ * Runs every due task in priority order while the loop is within budget.
+ */
+void task_scheduler_run(uint32_t loop_start) {
+    uint16_t now = timer_read();
+
+#if defined(DEBUG_TASK_SCHEDULER) && defined(CONSOLE_ENABLE)
+    static uint16_t stats_timer = 0;
+    if (TIMER_DIFF_16(now, stats_timer) > 1000) {
+        task_scheduler_print_stats();
+        task_scheduler_clear_stats();
+        stats_timer = now;
+    }
+#endif
+
+    for (uint8_t i = 0; i < task_count; i++) {
+        scheduled_task_t *task = &tasks[i];
+
+        if (task->period && TIMER_DIFF_16(now, task->last_run) < task->period) {
+            continue;
+        }
+
+        uint32_t start = timer_read_us();
+        // input tasks poll pins or devices that don't wait, they are never deferred
+        if (task->priority > TASK_PRIORITY_INPUT && start - loop_start >= TASK_SCHEDULER_BUDGET_US && task->deferrals < TASK_SCHEDULER_MAX_DEFERRALS) {
+            task->deferrals++;
+            task->deferred++;
+            continue;
+        }
+
+        task->func();
+
+        uint32_t elapsed = timer_read_us() - start;
+        task->last_run   = now;
+        task->deferrals  = 0;
+        task->runs++;
+        task->total_us += elapsed;
+        if (elapsed > task->max_us) {
+            task->max_us = elapsed;
+        }
+    }
+}
+
+uint8_t task_scheduler_count(void) { return task_count; }
+
+const scheduled_task_t *task_scheduler_get(uint8_t index) { return index < task_count ? &tasks[index] : 0; }
+
+void task_scheduler_clear_stats(void) {
+    for (uint8_t i = 0; i < task_count; i++) {
+        tasks[i].runs     = 0;
+        tasks[i].total_us = 0;
+        tasks[i].max_us   = 0;
+        tasks[i].deferred = 0;
+    }
+}
+
+/** \brief Print task statistics
+ *
+ * One line per task: priority, runs, average and maximum run time and how often it was deferred.
+ */
+void task_scheduler_print_stats(void) {
+    for (uint8_t i = 0; i < task_count; i++) {
+        dprintf("task %u: prio %u runs %lu avg %luus max %luus deferred %lu\n", i, tasks[i].priority, tasks[i].runs, tasks[i].runs ? tasks[i].total_us / tasks[i].runs : 0, tasks[i].max_us, tasks[i].deferred);
+    }
+}
@@ -0,0 +1,84 @@
+/* Copyright 2020 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Cooperative scheduler for the periodic work done by keyboard_task().
+ *
+ * Matrix scanning and key event dispatch always run first. Registered tasks then run in
+ * priority order (lowest number first) when their period has elapsed, for as long as the
+ * loop stays within TASK_SCHEDULER_BUDGET_US. A due task that doesn't fit is deferred to a
+ * later loop, but never more than TASK_SCHEDULER_MAX_DEFERRALS times in a row. Tasks with
+ * TASK_PRIORITY_INPUT are never deferred, a skipped poll would lose encoder steps or motion.
+ */
+
+#ifndef TASK_SCHEDULER_MAX_TASKS
+#    define TASK_SCHEDULER_MAX_TASKS 16
+#endif
+
+#ifndef TASK_SCHEDULER_BUDGET_US
+#    define TASK_SCHEDULER_BUDGET_US 1000
+#endif
+
+#ifndef TASK_SCHEDULER_MAX_DEFERRALS
+#    define TASK_SCHEDULER_MAX_DEFERRALS 8
+#endif
+
+/* Suggested priorities for the built in tasks */
+enum task_priority {
+    TASK_PRIORITY_INPUT    = 0,  // pointing devices, encoders, ... run on every loop
+    TASK_PRIORITY_DEFAULT  = 64,
+    TASK_PRIORITY_LIGHTING = 128,
+    TASK_PRIORITY_DISPLAY  = 192,
+};
+
+typedef void (*task_func_t)(void);
+
+typedef struct {
+    task_func_t func;
+    uint16_t    period;  // ms between runs, 0 to run on every loop
+    uint8_t     priority;
+    uint8_t     deferrals;
+    uint16_t    last_run;
+    // timing statistics
+    uint32_t runs;
+    uint32_t total_us;
+    uint32_t max_us;
+    uint32_t deferred;
+} scheduled_task_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* register a task, returns false if it's already registered or there's no room left */
+bool task_scheduler_register(task_func_t func, uint16_t period, uint8_t priority);
+/* change the period of a registered task */
+void task_scheduler_set_period(task_func_t func, uint16_t period);
+/* run the due tasks, loop_start is the timer_read_us() value at the start of the loop */
+void task_scheduler_run(uint32_t loop_start);
+
+uint8_t                 task_scheduler_count(void);
+const scheduled_task_t *task_scheduler_get(uint8_t index);
+void                    task_scheduler_clear_stats(void);
+void                    task_scheduler_print_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
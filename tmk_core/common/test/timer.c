@@ -16,18 +16,43 @@
 
 #include "timer.h"
 
-static uint32_t current_time = 0;
+/* simulated time in microseconds */
+static uint64_t current_time = 0;
+
+/* earliest deadline registered since the last clear_deadline() */
+static bool     deadline_pending = false;
+static uint64_t deadline         = 0;
 
 void timer_init(void) { current_time = 0; }
 
 void timer_clear(void) { current_time = 0; }
 
-uint16_t timer_read(void) { return current_time & 0xFFFF; }
-uint32_t timer_read32(void) { return current_time; }
+uint16_t timer_read(void) { return timer_read32() & 0xFFFF; }
+uint32_t timer_read32(void) { return current_time / 1000; }
 uint16_t timer_elapsed(uint16_t last) { return TIMER_DIFF_16(timer_read(), last); }
 uint32_t timer_elapsed32(uint32_t last) { return TIMER_DIFF_32(timer_read32(), last); }
+uint32_t timer_read_us(void) { return current_time; }
+
+void set_time(uint32_t t) { current_time = (uint64_t)t * 1000; }
+void advance_time(uint32_t ms) { current_time += (uint64_t)ms * 1000; }
+void advance_time_us(uint32_t us) { current_time += us; }
+
+void wait_ms(uint32_t ms) { advance_time(ms); }
+
+void timer_deadline(uint16_t time) {
+    uint16_t ms = time - timer_read();
+    // a deadline in the past is due now
+    uint64_t t = ms < 0x8000 ? (timer_read32() + ms) * (uint64_t)1000 : current_time;
+    if (!deadline_pending || t < deadline) {
+        deadline_pending = true;
+        deadline         = t;
+    }
+}
 
-void set_time(uint32_t t) { current_time = t; }
-void advance_time(uint32_t ms) { current_time += ms; }
+/* time until the earliest registered deadline, in microseconds */
+bool get_next_deadline(uint32_t *us) {
+    *us = deadline > current_time ? deadline - current_time : 0;
+    return deadline_pending;
+}
 
-void wait_ms(uint32_t ms) { advance_time(ms); }
\ No newline at end of file
+void clear_deadline(void) { deadline_pending = false; }
@@ -43,6 +43,16 @@ uint16_t timer_read(void);
 uint32_t timer_read32(void);
 uint16_t timer_elapsed(uint16_t last);
 uint32_t timer_elapsed32(uint32_t last);
+// Free running microsecond counter for profiling, resolution depends on the platform
+uint32_t timer_read_us(void);
+
+// Tells the simulated timer of the native tests the next timer_read() value the caller is waiting for,
+// so idle time up to it can be skipped. Compiles to nothing on real hardware.
+#ifdef TIMER_SIMULATION
+void timer_deadline(uint16_t time);
+#else
+#    define timer_deadline(time)
+#endif
 
 // Utility functions to check if a future time has expired & autmatically handle time wrapping if checked / reset frequently (half of max value)
 #define timer_expired(current, future) (((uint16_t)current - (uint16_t)future) < 0x8000)